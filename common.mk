@@ -7,6 +7,8 @@
 # compiler prefix
 ifeq ($(TARCH),MSP430)
 PREFIX  ?= msp430-
+else ifeq ($(TARCH),HOST)
+PREFIX  ?=
 else
 PREFIX	?= arm-none-eabi-
 endif
@@ -20,6 +22,11 @@ ifeq ($(TARCH),MSP430)
 INCDIR		+= -I./include 
 CFLAGS		+= -Os -g -mmcu=msp430g2553 -Wall -Wextra $(INCDIR) 
 LDFLAGS     	+= -mmcu=msp430g2553 $(LIBDIR) $(LIBS)
+else ifeq ($(TARCH),HOST)
+INCDIR		+= -I./include 
+CFLAGS		+= -O2 -g -Wall -Wextra -MD $(INCDIR) -DHOST
+LDSCRIPT	 =
+LDFLAGS		+= $(LIBDIR) $(LIBS) -lpthread
 else
 INCDIR		+= -I./include -I$(HOME)/sat/arm-none-eabi/include
 CFLAGS		+= -Os -g -Wall -Wextra -fno-common -mcpu=cortex-m3 -mthumb -msoft-float -MD $(INCDIR) -DSTM32F1
@@ -7,6 +7,8 @@
 # compiler prefix
 ifeq ($(TARCH),MSP430)
 PREFIX  ?= msp430-
+else ifeq ($(TARCH),HOST)
+PREFIX  ?=
 else
 PREFIX	?= arm-none-eabi-
 endif
@@ -17,6 +19,9 @@ AR			 = $(PREFIX)ar
 ifeq ($(TARCH),MSP430)
 INCDIR		+= -I./include 
 CFLAGS		+= -Os -g -mmcu=msp430g2553 -Wall -Wextra $(INCDIR) 
+else ifeq ($(TARCH),HOST)
+INCDIR		+= -I./include 
+CFLAGS		+= -O2 -g -Wall -Wextra -MD $(INCDIR) -DHOST
 else
 INCDIR		+= -I./include -I$(HOME)/sat/arm-none-eabi/include
 CFLAGS		+= -Os -g -Wall -Wextra -fno-common -mcpu=cortex-m3 -mthumb -msoft-float -MD $(INCDIR) -DSTM32F1
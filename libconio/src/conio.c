@@ -18,140 +18,378 @@
  */
 
 #include <stdarg.h>
+#include <limits.h>
 
 #include "conio.h"
 
-void cio_print(char *line)
+/**
+ * Size of the buffer for formating a decimal (enough for the digits
+ * of an unsigned long plus a sign).
+ */
+#define CIO_NUM_LEN		(3 * sizeof(unsigned long))
+
+/**
+ * Flag for left aligned fields ("%-").
+ */
+#define CIO_LEFT		1
+
+/**
+ * Flag for zero padded fields ("%0").
+ */
+#define CIO_ZERO		2
+
+/**
+ * Characters collected for the sink by one print call.
+ */
+typedef struct {
+     cio_sink     *sink;
+     unsigned char len;
+     char          buf[CIO_BUF_SIZE];
+} cio_out;
+
+static cio_sink *cio_cur = &cio_sink_serial;
+
+static void _flush(cio_out *o)
+{
+     if(o->len) {
+          o->sink->write(o->sink, o->buf, o->len);
+          o->len = 0;
+     }
+}
+
+static void _putc(cio_out *o, char c)
 {
-     int   i = 0;
+     o->buf[o->len++] = c;
 
-     while(line[i] != 0) {
-          cio_printc(line[i++]);
+     if(o->len == CIO_BUF_SIZE) {
+          _flush(o);
      }
 }
 
-void cio_printi(int n)
+static void _puts(cio_out *o, const char *line)
 {
-     int buffer[16];
-     int i;
-     int j;
+     unsigned short i = 0;
 
-     if(n == 0) {
-          cio_printc('0');
-          return;
+     while(line[i] != 0) i++;
+
+     // strings are passed to the sink directly, not through the buffer
+     _flush(o);
+     if(i) {
+          o->sink->write(o->sink, line, i);
      }
+}
 
-     for (i = 15; i > 0 && n > 0; i--) {
-          buffer[i] = (n%10)+'0';
-          n /= 10;
+static void _putn(cio_out *o, const char *buf, unsigned short len)
+{
+     while(len--) {
+          _putc(o, *buf++);
      }
+}
+
+/**
+ * Multiply by 10 with shifts and adds.
+ */
+#define _mul10(q)	(((q) << 3) + ((q) << 1))
+
+#ifdef MSP430
+/**
+ * Divide by 10 with shifts and adds: the MSP430G2553 has neither a
+ * hardware multiplier nor a divider, and the division routines of
+ * libgcc are slow. The quotient is estimated as n * 0.8 / 8 and
+ * corrected by the remainder.
+ */
+static unsigned long _divu10(unsigned long n)
+{
+     unsigned long q;
+
+     q  = (n >> 1) + (n >> 2);
+     q += q >> 4;
+     q += q >> 8;
+     q += q >> 16;
+     q >>= 3;
+
+     return q + ((n - _mul10(q)) > 9);
+}
+
+/**
+ * Same as {@link _divu10} for 16 bit.
+ */
+static unsigned int _divu10i(unsigned int n)
+{
+     unsigned int q;
+
+     q  = (n >> 1) + (n >> 2);
+     q += q >> 4;
+     q += q >> 8;
+     q >>= 3;
+
+     return q + ((n - _mul10(q)) > 9);
+}
+#else
+// the compiler turns a division by a constant into a multiply by its reciprocal
+#define _divu10(n)	((n) / 10)
+#define _divu10i(n)	((n) / 10)
+#endif
 
-     for(j = i+1; j <= 15; j++) {
-          cio_printc(buffer[j]);
+/**
+ * Format x as decimal into the buffer ending at p (backwards), and return
+ * the pointer to the first digit. If prec is not 0, a decimal point is put
+ * before the last prec digits (fixed-point). The buffer must hold
+ * CIO_NUM_LEN chars, prec must not exceed 9.
+ */
+static char *_utoa(char *p, unsigned long x, int prec)
+{
+     unsigned long q;
+     unsigned int  u;
+     unsigned int  v;
+
+     // use the wider division only until the rest fits into an int
+     while(x > UINT_MAX) {
+          q    = _divu10(x);
+          *--p = '0' + (char)(x - _mul10(q));
+          x    = q;
+          if(--prec == 0) *--p = '.';
      }
+
+     u = (unsigned int)x;
+
+     // continue with zeros until the digit before the decimal point is done
+     do {
+          v    = _divu10i(u);
+          *--p = '0' + (char)(u - _mul10(v));
+          u    = v;
+          if(--prec == 0) *--p = '.';
+     } while(u || prec >= 0);
+
+     return p;
 }
 
-void cio_printb(int n, int size)
+static const char _hex[16] = { '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'};
+
+/**
+ * Format x as hexadecimal with at least the given number of digits into
+ * the buffer ending at p (backwards), and return the pointer to the first
+ * digit.
+ */
+static char *_htoa(char *p, unsigned long x, unsigned char digits)
 {
+     char *end = p;
 
-     int i;
+     do {
+          *--p = _hex[x & 15];
+          x  >>= 4;
+     } while(x || end - p < digits);
 
-     int mask = 1 << (size - 1);
+     return p;
+}
 
-     for(i = 0; i < size; i++) {
-          if((n & (mask >> i)) != 0) {
-               cio_printc('1');
-          } else {
-               cio_printc('0');
-          }
+static void _pad(cio_out *o, char c, unsigned char n)
+{
+     while(n--) {
+          _putc(o, c);
      }
+}
+
+/**
+ * Put a formated number (or char) of len chars with its sign (0 for none)
+ * into a field of the given width.
+ */
+static void _field(cio_out *o, char sign, const char *p, unsigned char len,
+                   unsigned char width, unsigned char flags)
+{
+     unsigned char n   = len + (sign != 0);
+     unsigned char pad = (width > n ? width - n : 0);
 
+     if(!(flags & (CIO_LEFT | CIO_ZERO))) _pad(o, ' ', pad);
+     if(sign) _putc(o, sign);
+     if((flags & (CIO_LEFT | CIO_ZERO)) == CIO_ZERO) _pad(o, '0', pad);
+     _putn(o, p, len);
+     if(flags & CIO_LEFT) _pad(o, ' ', pad);
 }
 
-static const unsigned long _dv[] = {
-//   4294967296       // 32 bit unsigned max
-     1000000000,     // +0
-     100000000,     // +1
-     10000000,     // +2
-     1000000,     // +3
-     100000,     // +4
-//   65535      // 16 bit unsigned max
-     10000,    // +5
-     1000,    // +6
-     100,    // +7
-     10,    // +8
-     1,    // +9
-};
+cio_sink *cio_set_sink(cio_sink *sink)
+{
+     cio_sink *prev = cio_cur;
+
+     cio_cur = sink;
 
-static void _puth(unsigned int n)
+     return prev;
+}
+
+cio_sink *cio_get_sink()
 {
-     static const char hex[16] = { '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'};
-     cio_printc(hex[n & 15]);
+     return cio_cur;
 }
 
-static void _xtoa(unsigned long x, const unsigned long *dp)
+void cio_printc(char c)
 {
-     char c;
-     unsigned long d;
+     cio_cur->write(cio_cur, &c, 1);
+}
 
-     if(x) {
-          while(x < *dp) ++dp;
-          do {
-               d = *dp++;
-               c = '0';
-               while(x >= d) ++c, x -= d;
-               cio_printc(c);
-          } while(!(d & 1));
-     } else
-          cio_printc('0');
+void cio_print(char *line)
+{
+     cio_out o;
+
+     o.sink = cio_cur;
+     o.len  = 0;
+
+     _puts(&o, line);
 }
 
-void cio_printf(char *format, ...)
+void cio_printi(int n)
+{
+     char num[CIO_NUM_LEN];
+     char *p;
+
+     if(n < 0) {
+          p = _utoa(num + CIO_NUM_LEN, 0U - (unsigned int)n, 0);
+          *--p = '-';
+     } else {
+          p = _utoa(num + CIO_NUM_LEN, (unsigned int)n, 0);
+     }
+
+     cio_cur->write(cio_cur, p, (unsigned short)(num + CIO_NUM_LEN - p));
+}
+
+void cio_printb(int n, int size)
+{
+
+     int i;
+     cio_out o;
+
+     int mask = 1 << (size - 1);
+
+     o.sink = cio_cur;
+     o.len  = 0;
+
+     for(i = 0; i < size; i++) {
+          if((n & (mask >> i)) != 0) {
+               _putc(&o, '1');
+          } else {
+               _putc(&o, '0');
+          }
+     }
+     _flush(&o);
+
+}
+
+void cio_vfprintf(cio_sink *sink, char *format, va_list a)
 {
      char c;
      int i;
      long n;
+     unsigned long x;
+     char num[CIO_NUM_LEN];
+     char *end = num + CIO_NUM_LEN;
+     char *p;
+     char sign;
+     unsigned short len;
+     unsigned char flags;
+     unsigned char width;
+     int prec;
+     cio_out o;
 
-     va_list a;
-     va_start(a, format);
+     o.sink = sink;
+     o.len  = 0;
 
      while((c = *format++)) {
           if(c == '%') {
-               switch(c = *format++) {
+               flags = 0;
+               width = 0;
+               prec  = 0;
+               sign  = 0;
+
+               for(;;) {                       // Flags
+                    c = *format++;
+                    if(c == '-') flags |= CIO_LEFT;
+                    else if(c == '0') flags |= CIO_ZERO;
+                    else break;
+               }
+               while(c >= '0' && c <= '9') {   // Width
+                    width = _mul10(width) + (c - '0');
+                    c = *format++;
+               }
+               if(c == '.') {                  // Decimal places
+                    while((c = *format++) >= '0' && c <= '9') {
+                         prec = _mul10(prec) + (c - '0');
+                    }
+                    if(prec > 9) prec = 9;
+               }
+
+               switch(c) {
                case 's':                       // String
-                    cio_print(va_arg(a, char*));
+                    p = va_arg(a, char*);
+                    for(len = 0; p[len]; len++);
+                    if(width > len && !(flags & CIO_LEFT)) _pad(&o, ' ', width - len);
+                    _puts(&o, p);
+                    if(width > len && (flags & CIO_LEFT)) _pad(&o, ' ', width - len);
                     break;
                case 'c':                       // Char
-                    cio_printc((char)va_arg(a, int));
+                    num[0] = (char)va_arg(a, int);
+                    _field(&o, 0, num, 1, width, flags);
                     break;
                case 'i':                       // 16 bit Integer
                case 'u':                       // 16 bit Unsigned
                     i = va_arg(a, int);
-                    if(c == 'i' && i < 0) i = -i, cio_printc('-');
-                    _xtoa((unsigned)i, _dv + 5);
+                    if(c == 'i' && i < 0) {
+                         sign = '-';
+                         x    = 0U - (unsigned int)i;
+                    } else {
+                         x    = (unsigned int)i;
+                    }
+                    p = _utoa(end, x, prec);
+                    _field(&o, sign, p, (unsigned char)(end - p), width, flags);
                     break;
                case 'l':                       // 32 bit Long
+                    if(*format == 'x') {       // 32 bit heXadecimal
+                         format++;
+                         x = va_arg(a, unsigned long) & 0xFFFFFFFFUL;
+                         p = _htoa(end, x, width ? 1 : 8);
+                         _field(&o, 0, p, (unsigned char)(end - p), width, flags);
+                         break;
+                    }
+                    // fall through
                case 'n':                       // 32 bit uNsigned loNg
                     n = va_arg(a, long);
-                    if(c == 'l' &&  n < 0) n = -n, cio_printc('-');
-                    _xtoa((unsigned long)n, _dv);
+                    if(c == 'l' && n < 0) {
+                         sign = '-';
+                         x    = 0UL - (unsigned long)n;
+                    } else {
+                         x    = (unsigned long)n;
+                    }
+                    p = _utoa(end, x, prec);
+                    _field(&o, sign, p, (unsigned char)(end - p), width, flags);
                     break;
                case 'x':                       // 16 bit heXadecimal
-                    i = va_arg(a, int);
-                    _puth(i >> 12);
-                    _puth(i >> 8);
-                    _puth(i >> 4);
-                    _puth(i);
+                    x = (unsigned int)va_arg(a, int) & 0xFFFF;
+                    p = _htoa(end, x, width ? 1 : 4);
+                    _field(&o, 0, p, (unsigned char)(end - p), width, flags);
                     break;
                case 0:
+                    _flush(&o);
                     return;
                default:
                     goto bad_fmt;
                }
           } else
 bad_fmt:
-               cio_printc(c);
+               _putc(&o, c);
      }
+     _flush(&o);
+}
+
+void cio_fprintf(cio_sink *sink, char *format, ...)
+{
+     va_list a;
+     va_start(a, format);
+     cio_vfprintf(sink, format, a);
      va_end(a);
 }
 
+void cio_printf(char *format, ...)
+{
+     va_list a;
+     va_start(a, format);
+     cio_vfprintf(cio_cur, format, a);
+     va_end(a);
+}
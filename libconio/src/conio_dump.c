@@ -0,0 +1,145 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "conio.h"
+
+/**
+ * Bytes per line of a hex dump.
+ */
+#define CIO_HEX_BYTES	16
+
+/**
+ * Bytes per line of a binary dump.
+ */
+#define CIO_BIN_BYTES	4
+
+/**
+ * Size of the line buffer: offset, two spaces, the bytes, two spaces, the
+ * ASCII column and the line end (the binary dump needs less).
+ */
+#define CIO_LINE_LEN	(6 + 3 * CIO_HEX_BYTES + 1 + CIO_HEX_BYTES + 2)
+
+static const char _nibble_hex[16] = {
+	'0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'
+};
+
+static const char _nibble_bin[16][4] = {
+	"0000", "0001", "0010", "0011", "0100", "0101", "0110", "0111",
+	"1000", "1001", "1010", "1011", "1100", "1101", "1110", "1111"
+};
+
+/**
+ * Put the offset of a line ("0000  ") at the start of the line buffer.
+ */
+static char *_offset(char *p, unsigned short offset)
+{
+	*p++ = _nibble_hex[(offset >> 12) & 15];
+	*p++ = _nibble_hex[(offset >>  8) & 15];
+	*p++ = _nibble_hex[(offset >>  4) & 15];
+	*p++ = _nibble_hex[ offset        & 15];
+	*p++ = ' ';
+	*p++ = ' ';
+
+	return p;
+}
+
+void cio_hexdump(const void *buf, unsigned short len)
+{
+	const unsigned char *b = (const unsigned char *)buf;
+	cio_sink *sink = cio_get_sink();
+	char line[CIO_LINE_LEN];
+	char *p;
+	char *a;
+	unsigned short offset = 0;
+	unsigned char n;
+	unsigned char i;
+	unsigned char c;
+
+	// loop on the remaining length, offset + i would wrap for len near 64k
+	while(len > 0) {
+		n = (len < CIO_HEX_BYTES ? len : CIO_HEX_BYTES);
+		p = _offset(line, offset);
+
+		// the ASCII column follows the hex column
+		a = p + 3 * CIO_HEX_BYTES + 1;
+
+		for(i = 0; i < CIO_HEX_BYTES; i++) {
+			if(i < n) {
+				c      = b[i];
+				*p++   = _nibble_hex[c >> 4];
+				*p++   = _nibble_hex[c & 15];
+				*a++   = (c >= ' ' && c <= '~' ? c : '.');
+			} else {
+				*p++   = ' ';
+				*p++   = ' ';
+			}
+			*p++ = ' ';
+		}
+
+		*p   = ' ';
+		*a++ = '\n';
+		*a++ = '\r';
+
+		sink->write(sink, line, (unsigned short)(a - line));
+
+		b      += n;
+		len    -= n;
+		offset += n;
+	}
+}
+
+void cio_bindump(const void *buf, unsigned short len)
+{
+	const unsigned char *b = (const unsigned char *)buf;
+	cio_sink *sink = cio_get_sink();
+	char line[CIO_LINE_LEN];
+	char *p;
+	const char *n;
+	unsigned short offset = 0;
+	unsigned char cnt;
+	unsigned char i;
+	unsigned char c;
+
+	while(len > 0) {
+		cnt = (len < CIO_BIN_BYTES ? len : CIO_BIN_BYTES);
+		p   = _offset(line, offset);
+
+		for(i = 0; i < cnt; i++) {
+			c = b[i];
+
+			if(i) {
+				*p++ = ' ';
+			}
+
+			n = _nibble_bin[c >> 4];
+			*p++ = n[0]; *p++ = n[1]; *p++ = n[2]; *p++ = n[3];
+			n = _nibble_bin[c & 15];
+			*p++ = n[0]; *p++ = n[1]; *p++ = n[2]; *p++ = n[3];
+		}
+
+		*p++ = '\n';
+		*p++ = '\r';
+
+		sink->write(sink, line, (unsigned short)(p - line));
+
+		b      += cnt;
+		len    -= cnt;
+		offset += cnt;
+	}
+}
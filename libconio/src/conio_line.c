@@ -0,0 +1,104 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "conio_line.h"
+
+int cio_line_init(cio_line *line, char *buf, unsigned char size, cio_sink *echo)
+{
+	if(size == 0) {
+		return -1;
+	}
+
+	line->buf   = buf;
+	line->size  = size;
+	line->len   = 0;
+	line->flags = 0;
+	line->echo  = echo;
+
+	buf[0] = 0;
+
+	return 0;
+}
+
+int cio_line_put(cio_line *line, char c)
+{
+	unsigned char eol = 0;
+
+	// start a new line after the last one was taken
+	if(line->flags & CIO_LINE_DONE) {
+		line->flags &= ~CIO_LINE_DONE;
+		line->len    = 0;
+	}
+
+	if(c == '\r') {
+		eol = CIO_LINE_CR;
+	} else if(c == '\n') {
+		eol = CIO_LINE_LF;
+	}
+
+	if(eol) {
+		// second half of a CR/LF (or LF/CR) pair
+		if(line->len == 0 && (line->flags & (CIO_LINE_CR | CIO_LINE_LF)) &&
+		   !(line->flags & eol)) {
+			line->flags &= ~(CIO_LINE_CR | CIO_LINE_LF);
+			return 0;
+		}
+
+		line->flags &= ~(CIO_LINE_CR | CIO_LINE_LF);
+		line->flags |= eol | CIO_LINE_DONE;
+		line->buf[line->len] = 0;
+
+		if(line->echo) {
+			line->echo->write(line->echo, "\n\r", 2);
+		}
+
+		return 1;
+	}
+
+	line->flags &= ~(CIO_LINE_CR | CIO_LINE_LF);
+
+	if(c == '\b' || c == 0x7F) {
+		if(line->len > 0) {
+			line->len--;
+
+			if(line->echo) {
+				line->echo->write(line->echo, "\b \b", 3);
+			}
+		}
+	} else if(c >= ' ' && line->len < line->size - 1) {
+		line->buf[line->len++] = c;
+
+		if(line->echo) {
+			line->echo->write(line->echo, &c, 1);
+		}
+	}
+
+	return 0;
+}
+
+int cio_line_poll(cio_line *line, serial_rb *rb)
+{
+	while(!serial_rb_empty(rb)) {
+		if(cio_line_put(line, (char)serial_rb_read(rb))) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
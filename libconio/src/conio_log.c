@@ -0,0 +1,188 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdarg.h>
+
+#include "conio_log.h"
+
+#ifdef HOST
+/* The host linker places the orphan section and provides its start. */
+#define _cio_log_fmt_start	__start_cio_log_fmt
+#endif
+
+/**
+ * Start of the "cio_log_fmt" section (defined in the linker script of the
+ * firmware, see "tests/firmware_stm32_103.ld").
+ */
+extern const char _cio_log_fmt_start[];
+
+static serial_rb *cio_log_rb = 0;
+
+static unsigned long (*cio_log_time)(void) = 0;
+
+static unsigned short cio_log_drops = 0;
+
+/**
+ * Append len bytes of the value at v to the record at *pos, if they fit.
+ * Returns -1 if not, all following arguments must then be left out too,
+ * since the decoder takes the arguments by their position.
+ */
+static int _put(unsigned char *rec, unsigned char *pos, const void *v, unsigned char len)
+{
+	const unsigned char *b = (const unsigned char *)v;
+
+	if(*pos + len > CIO_LOG_MAX + 1) {
+		return -1;
+	}
+
+	while(len--) {
+		rec[(*pos)++] = *b++;
+	}
+
+	return 0;
+}
+
+void cio_log_init(serial_rb *rb, unsigned long (*time)(void))
+{
+	cio_log_rb    = rb;
+	cio_log_time  = time;
+	cio_log_drops = 0;
+}
+
+void cio_log(const char *format, ...)
+{
+	// record starts at 1, rec[0] is the COBS code of the first block
+	unsigned char rec[CIO_LOG_MAX + 2];
+	unsigned char pos = 1;
+	int full = 0;
+	unsigned char code;
+	unsigned char i;
+	unsigned short id;
+	unsigned long t;
+	const char *f = format;
+	const char *s;
+	char c;
+	int n;
+	long l;
+	va_list a;
+
+	if(!cio_log_rb) {
+		cio_log_drops++;
+		return;
+	}
+
+	id = (unsigned short)(format - _cio_log_fmt_start);
+
+	if(cio_log_time) {
+		id |= CIO_LOG_TIME;
+		t   = cio_log_time();
+	}
+
+	_put(rec, &pos, &id, sizeof(id));
+
+	if(cio_log_time) {
+		full = _put(rec, &pos, &t, 4);
+	}
+
+	va_start(a, format);
+
+	while(!full && (c = *f++)) {
+		if(c != '%') {
+			continue;
+		}
+
+		// flags, width and decimal places do not change the arguments
+		while(*f == '-' || *f == '.' || (*f >= '0' && *f <= '9')) {
+			f++;
+		}
+
+		switch(*f++) {
+		case 'c':
+			c    = (char)va_arg(a, int);
+			full = _put(rec, &pos, &c, 1);
+			break;
+		case 'i':
+		case 'u':
+		case 'x':
+			n    = va_arg(a, int);
+			full = _put(rec, &pos, &n, sizeof(n));
+			break;
+		case 'l':
+			if(*f == 'x') {
+				f++;
+			}
+			// fall through
+		case 'n':
+			l    = va_arg(a, long);
+			full = _put(rec, &pos, &l, sizeof(l));
+			break;
+		case 's':
+			s = va_arg(a, const char *);
+			if(pos > CIO_LOG_MAX) {
+				full = -1;
+				break;
+			}
+			// a cut off string is still terminated, thus stays decodable
+			while(*s && pos < CIO_LOG_MAX) {
+				rec[pos++] = *s++;
+			}
+			rec[pos++] = 0;
+			break;
+		case 0:
+			f--;
+			break;
+		}
+	}
+
+	va_end(a);
+
+	// COBS encode in place: each zero is replaced by the distance to the next
+	code = 0;
+	for(i = 1; i < pos; i++) {
+		if(rec[i] == 0) {
+			rec[code] = i - code;
+			code      = i;
+		}
+	}
+	rec[code] = pos - code;
+	rec[pos++] = 0;
+
+	if(serial_rb_free(cio_log_rb) < pos) {
+		cio_log_drops++;
+		return;
+	}
+
+	serial_rb_write_block(cio_log_rb, rec, pos);
+}
+
+void cio_log_flush(cio_sink *sink)
+{
+	unsigned short len;
+	SERIAL_RB_Q *q;
+
+	while((q = serial_rb_peek(cio_log_rb, &len)) && len) {
+		sink->write(sink, (const char *)q, len);
+		serial_rb_consume(cio_log_rb, len);
+	}
+}
+
+unsigned short cio_log_dropped()
+{
+	return cio_log_drops;
+}
@@ -20,11 +20,6 @@
 #include "serial.h"
 #include "conio.h"
 
-void cio_printc(char c)
-{
-     serial_send_blocking(c);
-}
-
 char cio_getc()
 {
 	return serial_recv_blocking();
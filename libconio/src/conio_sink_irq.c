@@ -0,0 +1,30 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "serial_irq.h"
+#include "conio_sink_irq.h"
+
+static void cio_sink_irq_write(cio_sink *sink, const char *buf, unsigned short len)
+{
+	(void)sink;
+
+	serial_write((const unsigned char *)buf, len);
+}
+
+cio_sink cio_sink_irq = { cio_sink_irq_write };
@@ -0,0 +1,62 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "conio.h"
+
+static void cio_sink_mem_write(cio_sink *sink, const char *buf, unsigned short len)
+{
+	cio_sink_mem *mem = (cio_sink_mem *)sink;
+	unsigned short i;
+
+	for(i = 0; i < len && mem->len + 1 < mem->size; i++) {
+		mem->buf[mem->len++] = buf[i];
+	}
+
+	// count what did not fit, to return the full length from cio_snprintf
+	mem->len += len - i;
+
+	if(mem->size) {
+		mem->buf[mem->len < mem->size ? mem->len : mem->size - 1] = 0;
+	}
+}
+
+void cio_sink_mem_init(cio_sink_mem *mem, char *buf, unsigned short size)
+{
+	mem->sink.write = cio_sink_mem_write;
+	mem->buf  		= buf;
+	mem->size 		= size;
+	mem->len  		= 0;
+
+	if(size) {
+		buf[0] = 0;
+	}
+}
+
+int cio_snprintf(char *buf, unsigned short size, char *format, ...)
+{
+	cio_sink_mem mem;
+
+	va_list a;
+	va_start(a, format);
+	cio_sink_mem_init(&mem, buf, size);
+	cio_vfprintf(&mem.sink, format, a);
+	va_end(a);
+
+	return mem.len;
+}
@@ -0,0 +1,58 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "conio_sink_nrf.h"
+
+void cio_sink_nrf_flush(cio_sink_nrf *s)
+{
+	if(s->len) {
+		// pad with zeros to the configured payload size
+		while(s->len < s->payload.size) {
+			s->payload.data[s->len++] = 0;
+		}
+		nrf_send_blocking(&s->payload);
+		s->len = 0;
+	}
+}
+
+static void cio_sink_nrf_write(cio_sink *sink, const char *buf, unsigned short len)
+{
+	cio_sink_nrf *s = (cio_sink_nrf *)sink;
+	char c;
+
+	while(len--) {
+		c = *buf++;
+		s->payload.data[s->len++] = c;
+
+		if(s->len == s->payload.size) {
+			nrf_send_blocking(&s->payload);
+			s->len = 0;
+		}
+		else if(c == '\n') {
+			cio_sink_nrf_flush(s);
+		}
+	}
+}
+
+void cio_sink_nrf_init(cio_sink_nrf *s, unsigned char size)
+{
+	s->sink.write 	= cio_sink_nrf_write;
+	s->payload.size = size;
+	s->len 			= 0;
+}
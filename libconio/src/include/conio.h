@@ -20,6 +20,87 @@
 #ifndef __CONIO_H_
 #define __CONIO_H_
 
+#include <stdarg.h>
+
+/**
+ * Size of the buffer in which the print functions collect characters
+ * before handing them to the sink.
+ */
+#ifndef CIO_BUF_SIZE
+#define CIO_BUF_SIZE	16
+#endif
+
+/**
+ * Output sink of the console. All print functions format into a small
+ * buffer, and pass it in one go to the "write" function of the current
+ * sink. A custom sink embeds this struct as its first member, and
+ * casts the pointer passed to "write" back to its own type.
+ */
+typedef struct cio_sink {
+
+	/**
+	 * Write "len" characters from "buf" to the sink.
+	 */
+	void (*write)(struct cio_sink *sink, const char *buf, unsigned short len);
+} cio_sink;
+
+/**
+ * Sink formatting into a memory buffer (see {@link cio_sink_mem_init}).
+ */
+typedef struct {
+
+	/**
+	 * The sink.
+	 */
+	cio_sink sink;
+
+	/**
+	 * The memory buffer.
+	 */
+	char *buf;
+
+	/**
+	 * Size of the memory buffer.
+	 */
+	unsigned short size;
+
+	/**
+	 * Number of characters written to the sink (including the ones
+	 * not fitting into the buffer).
+	 */
+	unsigned short len;
+} cio_sink_mem;
+
+/**
+ * Sink writing blocking to the serial line (the default sink).
+ */
+extern cio_sink cio_sink_serial;
+
+/**
+ * Set the sink used by the print functions.
+ *
+ * @param[in] *sink	the sink to use
+ * @return			the sink used before
+ */
+cio_sink *cio_set_sink(cio_sink *sink);
+
+/**
+ * Get the sink used by the print functions.
+ *
+ * @return			the sink currently used
+ */
+cio_sink *cio_get_sink();
+
+/**
+ * Initialize a memory sink. The buffer is always kept null terminated,
+ * characters not fitting into it are dropped.
+ *
+ * @param[in] *mem	the memory sink to initialize
+ * @param[in] *buf	the memory buffer
+ * @param[in] size	size of the memory buffer
+ */
+void cio_sink_mem_init(cio_sink_mem *mem, char *buf, unsigned short size);
+
 /**
  * Print a character to the console.
  *
@@ -49,6 +130,32 @@ void cio_printi(int n);
  */
 void cio_printb(int n, int size);
 
+/**
+ * Print a hex dump of a buffer to the console. Each line shows the offset,
+ * 16 bytes in hex and as ASCII (non printable characters as "."):
+ * <pre>
+ * 0000  48 65 6C 6C 6F 00 01 02 03 04 05 06 07 08 09 0A  Hello...........
+ * </pre>
+ * Each line is passed to the sink in one write.
+ *
+ * @param[in] *buf	the buffer to dump
+ * @param[in] len	number of bytes to dump
+ */
+void cio_hexdump(const void *buf, unsigned short len);
+
+/**
+ * Print a binary dump of a buffer to the console. Each line shows the
+ * offset and 4 bytes in binary (MSB first), e.g. for register snapshots:
+ * <pre>
+ * 0000  00001000 00111111 00000011 00000011
+ * </pre>
+ * Each line is passed to the sink in one write.
+ *
+ * @param[in] *buf	the buffer to dump
+ * @param[in] len	number of bytes to dump
+ */
+void cio_bindump(const void *buf, unsigned short len);
+
 /**
  * Print a formated string. The following formt specifiers could
  * be used in the format string:
@@ -60,12 +167,58 @@ void cio_printb(int n, int size);
  * Long          	%l
  * unsigned long 	%n
  * heX          	%x
+ * Long heX       	%lx
+ * </pre>
+ * Between "%" and the specifier, optional flags, a field width and a
+ * number of decimal places could be given ("%[-0][width][.places]"):
+ * <pre>
+ * -				left align within the field
+ * 0				pad numbers with zeros instead of spaces
+ * width			min. number of characters to print
+ * .places			print an integer as fixed-point number with the given
+ * 					number of decimal places (%i %u %l %n, max. 9)
  * </pre>
+ * Without a width, %x prints 4 and %lx 8 digits. With a width, only the
+ * digits needed are printed, padded to the width.
+ *
  * @param[in] *format	the format string
  * @param[in] ...		the values to put into the format string
  */
 void cio_printf(char *format, ...);
 
+/**
+ * Print a formated string (see {@link cio_printf}) to the given sink.
+ *
+ * @param[in] *sink		the sink to print to
+ * @param[in] *format	the format string
+ * @param[in] ...		the values to put into the format string
+ */
+void cio_fprintf(cio_sink *sink, char *format, ...);
+
+/**
+ * Print a formated string (see {@link cio_printf}) to the given sink,
+ * taking the values from a va_list.
+ *
+ * @param[in] *sink		the sink to print to
+ * @param[in] *format	the format string
+ * @param[in] a			the values to put into the format string
+ */
+void cio_vfprintf(cio_sink *sink, char *format, va_list a);
+
+/**
+ * Print a formated string (see {@link cio_printf}) into a memory buffer.
+ * At most size - 1 characters are written, and the buffer is always null
+ * terminated (if size is not 0).
+ *
+ * @param[out] *buf		the memory buffer
+ * @param[in] size		size of the memory buffer
+ * @param[in] *format	the format string
+ * @param[in] ...		the values to put into the format string
+ * @return				length of the formated string (which was truncated
+ * 						if not less than size)
+ */
+int cio_snprintf(char *buf, unsigned short size, char *format, ...);
+
 /**
  * Read a character form the console.
  *
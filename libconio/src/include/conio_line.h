@@ -0,0 +1,115 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CONIO_LINE_H_
+#define __CONIO_LINE_H_
+
+#include "conio.h"
+#include "serial_rb.h"
+
+/**
+ * Internal: the last line was ended by CR.
+ */
+#define CIO_LINE_CR			0x02
+
+/**
+ * Internal: the last line was ended by LF.
+ */
+#define CIO_LINE_LF			0x04
+
+/**
+ * Internal: the line in the buffer is complete.
+ */
+#define CIO_LINE_DONE		0x08
+
+/**
+ * State of a non-blocking line editor.
+ */
+typedef struct {
+
+	/**
+	 * Buffer for the line.
+	 */
+	char *buf;
+
+	/**
+	 * Size of the buffer (incl. the terminating zero).
+	 */
+	unsigned char size;
+
+	/**
+	 * Number of characters in the buffer.
+	 */
+	unsigned char len;
+
+	/**
+	 * CIO_LINE_* flags.
+	 */
+	unsigned char flags;
+
+	/**
+	 * Sink the typed characters are echoed to (NULL for no echo).
+	 */
+	cio_sink *echo;
+} cio_line;
+
+/**
+ * Initialize a line editor. The echo is written directly to the given
+ * sink, not to the current one. When receiving interrupt driven, use
+ * a non-blocking sink like "cio_sink_irq" (see "conio_sink_irq.h"), since
+ * the blocking serial sink would compete with the TX ISR for the USART.
+ *
+ * @param[in] *line		the line editor to initialize
+ * @param[in] *buf		buffer for the line (e.g. SHELL_MAX_CMD_LINE chars)
+ * @param[in] size		size of the buffer (at least 1)
+ * @param[in] *echo		sink to echo the characters typed to, NULL for no echo
+ * @return				0 on success, -1 if size is 0
+ */
+int cio_line_init(cio_line *line, char *buf, unsigned char size, cio_sink *echo);
+
+/**
+ * Pass one character to the line editor (e.g. from the RX ISR). CR or LF
+ * (or both) end a line, backspace or DEL remove the last character.
+ * Characters not fitting into the buffer and other control characters
+ * are ignored. If enabled, the characters are echoed to the echo sink.
+ * <br/>
+ * Once a line is complete, the buffer holds the null terminated line
+ * (which is empty if only CR/LF was typed) until the next character is
+ * passed.
+ *
+ * @param[in] *line		the line editor
+ * @param[in] c			the character
+ * @return				1 if a line is complete, 0 otherwise
+ */
+int cio_line_put(cio_line *line, char c);
+
+/**
+ * Pass the characters queued in a ringbuffer (e.g. the RX ringbuffer of
+ * "serial_irq_init") to the line editor, without blocking. Stops after
+ * a complete line, thus the following characters stay in the ringbuffer.
+ * With flow control enabled for the ringbuffer, call
+ * "serial_port_flow_update" afterwards.
+ *
+ * @param[in] *line		the line editor
+ * @param[in] *rb		the ringbuffer to read from (as consumer)
+ * @return				1 if a line is complete, 0 otherwise
+ */
+int cio_line_poll(cio_line *line, serial_rb *rb);
+
+#endif
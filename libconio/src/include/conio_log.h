@@ -0,0 +1,109 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CONIO_LOG_H_
+#define __CONIO_LOG_H_
+
+#include "conio.h"
+#include "serial_rb.h"
+
+/**
+ * Max. size of a log record (before framing, max. 253). A string not
+ * fitting into a record is cut off, any other argument not fitting is
+ * left out together with all following arguments.
+ */
+#ifndef CIO_LOG_MAX
+#define CIO_LOG_MAX		32
+#endif
+
+/**
+ * Bit set in the ID of a record carrying a timestamp.
+ */
+#define CIO_LOG_TIME	0x8000
+
+/**
+ * Log a formated message (see {@link cio_printf}) without formatting it
+ * on the target. The format string is only stored in the section
+ * "cio_log_fmt" of the firmware, and a compact binary record is written
+ * to the log ringbuffer:
+ * <pre>
+ * ID           2 bytes, offset of the format string in "cio_log_fmt",
+ *              bit 15 set if a timestamp follows
+ * timestamp    4 bytes (optional, see {@link cio_log_init})
+ * arguments    raw bytes in the order of the format string:
+ *              %c 1 byte, %i %u %x sizeof(int) bytes, %l %n sizeof(long)
+ *              bytes, %s the characters and a terminating zero
+ * </pre>
+ * All values are in the byte order of the target. The record is COBS
+ * encoded and ended by a zero byte. The host tool "cio_log_decode"
+ * reconstructs the messages using the format strings read from the ELF
+ * file of the firmware.
+ * <br/>
+ * The format must be a string literal, and the format strings of all
+ * records must not exceed 32KB.
+ *
+ * @param[in] format	the format string (literal)
+ * @param[in] ...		the values to put into the format string
+ */
+#define CIO_LOG(format, ...)												\
+	do {																	\
+		static const char _cio_log_fmt[]									\
+			__attribute__((section("cio_log_fmt"), used)) = format;			\
+		cio_log(_cio_log_fmt, ##__VA_ARGS__);								\
+	} while(0)
+
+/**
+ * Initialize deferred logging. The records are queued in the given
+ * ringbuffer, and passed on to a sink by {@link cio_log_flush} later on.
+ * <br/>
+ * The ringbuffer has one producer: log either from one ISR, or from
+ * the main loop with interrupts disabled.
+ *
+ * @param[in] *rb		ringbuffer for the records
+ * @param[in] time		function returning a timestamp for each record (e.g.
+ * 						"serial_time_ms"), 0 for records without timestamp
+ */
+void cio_log_init(serial_rb *rb, unsigned long (*time)(void));
+
+/**
+ * Write a log record for a format string placed in "cio_log_fmt".
+ * Use {@link CIO_LOG} instead of calling this directly.
+ *
+ * @param[in] *format	the format string (in the "cio_log_fmt" section)
+ * @param[in] ...		the values to put into the format string
+ */
+void cio_log(const char *format, ...);
+
+/**
+ * Pass the queued records to a sink (e.g. {@link cio_sink_serial}), from
+ * the main loop.
+ *
+ * @param[in] *sink		the sink to write the records to
+ */
+void cio_log_flush(cio_sink *sink);
+
+/**
+ * Get the number of records dropped since they did not fit into the
+ * ringbuffer.
+ *
+ * @return		number of records dropped
+ */
+unsigned short cio_log_dropped();
+
+#endif
@@ -0,0 +1,35 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CONIO_SINK_IRQ_H_
+#define __CONIO_SINK_IRQ_H_
+
+#include "conio.h"
+
+/**
+ * Sink queueing to the TX ringbuffer of the default USART through
+ * "serial_write", which also starts the interrupt driven transmission
+ * (requires "serial_irq_init"). Characters not fitting into the TX
+ * ringbuffer are dropped.
+ * <br/>
+ * Note: using this sink links the ISRs of libserial.
+ */
+extern cio_sink cio_sink_irq;
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CONIO_SINK_NRF_H_
+#define __CONIO_SINK_NRF_H_
+
+#include "conio.h"
+#include "nrf24l01.h"
+
+/**
+ * Sink sending through the nRF24l01 (see {@link cio_sink_nrf_init}).
+ */
+typedef struct {
+
+	/**
+	 * The sink.
+	 */
+	cio_sink sink;
+
+	/**
+	 * Payload the text is collected in.
+	 */
+	nrf_payload payload;
+
+	/**
+	 * Number of characters in the payload.
+	 */
+	unsigned char len;
+} cio_sink_nrf;
+
+/**
+ * Initialize a radio sink. The formated text is collected in payloads
+ * of the given size, which are sent (blocking) when filled, or when a
+ * newline was written (the payload is then padded with zeros).
+ * <br/>
+ * The nRF24l01 must be configured as PTX with the same payload size.
+ *
+ * @param[in] *s	the radio sink to initialize
+ * @param[in] size	payload size (1 to NRF_MAX_PAYLOAD)
+ */
+void cio_sink_nrf_init(cio_sink_nrf *s, unsigned char size);
+
+/**
+ * Send the text collected so far in the current payload (padded with
+ * zeros), e.g. for output not ending with a newline.
+ *
+ * @param[in] *s	the radio sink
+ */
+void cio_sink_nrf_flush(cio_sink_nrf *s);
+
+#endif
@@ -0,0 +1,55 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CONIO_SINK_RB_H_
+#define __CONIO_SINK_RB_H_
+
+#include "conio.h"
+#include "serial_rb.h"
+
+/**
+ * Sink writing into a ringbuffer (see {@link cio_sink_rb_init}).
+ */
+typedef struct {
+
+	/**
+	 * The sink.
+	 */
+	cio_sink sink;
+
+	/**
+	 * The ringbuffer written to.
+	 */
+	serial_rb *rb;
+} cio_sink_rb;
+
+/**
+ * Initialize a ringbuffer sink. The formated text is written to the
+ * ringbuffer (as producer) without waiting for it to be sent. Sending
+ * is not started by the sink, the ringbuffer has to be drained by
+ * "serial_dma_send_rb" or by an own task. To feed the TX ISR, use
+ * "cio_sink_irq" (see "conio_sink_irq.h") instead. Characters not fitting into the
+ * ringbuffer are dropped.
+ *
+ * @param[in] *s	the ringbuffer sink to initialize
+ * @param[in] *rb	the ringbuffer to write to
+ */
+void cio_sink_rb_init(cio_sink_rb *s, serial_rb *rb);
+
+#endif
@@ -0,0 +1,365 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Host tool decoding the records written by CIO_LOG (see conio_log.h).
+ *
+ * The format strings are read from the "cio_log_fmt" section of the ELF file
+ * of the firmware, the COBS framed records from stdin (e.g. the serial
+ * port of the target set up with "stty -F /dev/ttyUSB0 9600 raw").
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <elf.h>
+
+#ifndef EM_MSP430
+#define EM_MSP430	105
+#endif
+
+/**
+ * Max. size of a record (must not be less than CIO_LOG_MAX of the target).
+ */
+#define REC_MAX		256
+
+/**
+ * Format strings from the "cio_log_fmt" section.
+ */
+static char *fmts;
+
+static unsigned long fmts_len;
+
+/**
+ * Size of int and long on the target.
+ */
+static int int_size;
+
+static int long_size;
+
+static void die(const char *msg)
+{
+	fprintf(stderr, "cio_log_decode: %s\n", msg);
+	exit(1);
+}
+
+/**
+ * Read the section "cio_log_fmt" of an ELF file (32 or 64 bit, little endian).
+ */
+static void read_elf(const char *name)
+{
+	FILE *f;
+	unsigned char *elf;
+	long size;
+	int i;
+
+	if(!(f = fopen(name, "rb"))) {
+		die("unable to open ELF file");
+	}
+
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	elf = malloc(size);
+
+	if(fread(elf, 1, size, f) != (size_t)size) {
+		die("unable to read ELF file");
+	}
+
+	fclose(f);
+
+	if(size < EI_NIDENT || memcmp(elf, ELFMAG, SELFMAG) != 0) {
+		die("not an ELF file");
+	}
+
+	if(elf[EI_DATA] != ELFDATA2LSB) {
+		die("only little endian targets are supported");
+	}
+
+	if(elf[EI_CLASS] == ELFCLASS32) {
+		Elf32_Ehdr *eh = (Elf32_Ehdr *)elf;
+		Elf32_Shdr *sh = (Elf32_Shdr *)(elf + eh->e_shoff);
+		const char *names = (const char *)(elf + sh[eh->e_shstrndx].sh_offset);
+
+		int_size  = (eh->e_machine == EM_MSP430 ? 2 : 4);
+		long_size = 4;
+
+		for(i = 0; i < eh->e_shnum; i++) {
+			if(strcmp(names + sh[i].sh_name, "cio_log_fmt") == 0) {
+				fmts     = (char *)(elf + sh[i].sh_offset);
+				fmts_len = sh[i].sh_size;
+			}
+		}
+	} else {
+		Elf64_Ehdr *eh = (Elf64_Ehdr *)elf;
+		Elf64_Shdr *sh = (Elf64_Shdr *)(elf + eh->e_shoff);
+		const char *names = (const char *)(elf + sh[eh->e_shstrndx].sh_offset);
+
+		int_size  = 4;
+		long_size = 8;
+
+		for(i = 0; i < eh->e_shnum; i++) {
+			if(strcmp(names + sh[i].sh_name, "cio_log_fmt") == 0) {
+				fmts     = (char *)(elf + sh[i].sh_offset);
+				fmts_len = sh[i].sh_size;
+			}
+		}
+	}
+
+	if(!fmts) {
+		die("no cio_log_fmt section in ELF file");
+	}
+}
+
+/**
+ * Get a little endian value of len bytes from the record, sign extended
+ * if requested. Returns 0 if the record is too short.
+ */
+static int get(const unsigned char *rec, int len, int *pos, int size, int sign, long long *v)
+{
+	unsigned long long u = 0;
+	int i;
+
+	if(*pos + size > len) {
+		return 0;
+	}
+
+	for(i = size - 1; i >= 0; i--) {
+		u = (u << 8) | rec[*pos + i];
+	}
+
+	if(sign && size < 8 && (u & (1ULL << (size * 8 - 1)))) {
+		u |= ~0ULL << (size * 8);
+	}
+
+	*pos += size;
+	*v    = (long long)u;
+
+	return 1;
+}
+
+/**
+ * Print a formated value into a field as cio_printf does.
+ */
+static void field(char sign, const char *str, int width, int left, int zero)
+{
+	int len = strlen(str) + (sign != 0);
+	int pad = (width > len ? width - len : 0);
+
+	if(!left && !zero) printf("%*s", pad, "");
+	if(sign) putchar(sign);
+	if(!left && zero) while(pad--) putchar('0');
+	fputs(str, stdout);
+	if(left) printf("%*s", pad, "");
+}
+
+/**
+ * Format an unsigned value as decimal with prec decimal places.
+ */
+static void fixed(char *buf, unsigned long long u, int prec)
+{
+	char digits[32];
+	int n;
+
+	n = sprintf(digits, "%0*llu", prec + 1, u);
+
+	if(prec) {
+		sprintf(buf, "%.*s.%s", n - prec, digits, digits + n - prec);
+	} else {
+		strcpy(buf, digits);
+	}
+}
+
+/**
+ * Print one decoded record.
+ */
+static void print_record(const unsigned char *rec, int len)
+{
+	int pos = 0;
+	long long v;
+	unsigned int id;
+	const char *f;
+	char buf[48];
+	char sign;
+	char c;
+	int left;
+	int zero;
+	int width;
+	int prec;
+	int size;
+
+	if(!get(rec, len, &pos, 2, 0, &v)) {
+		return;
+	}
+
+	id = (unsigned int)v;
+
+	if(id & 0x8000) {
+		if(!get(rec, len, &pos, 4, 0, &v)) {
+			return;
+		}
+		printf("[%10llu] ", v);
+	}
+
+	if((id & 0x7FFF) >= fmts_len) {
+		printf("<unknown id %u>\n", id & 0x7FFF);
+		return;
+	}
+
+	f = fmts + (id & 0x7FFF);
+
+	while((c = *f++)) {
+		if(c != '%') {
+			putchar(c);
+			continue;
+		}
+
+		left  = zero = 0;
+		width = prec = 0;
+		sign  = 0;
+
+		for(;;) {
+			c = *f++;
+			if(c == '-') left = 1;
+			else if(c == '0') zero = 1;
+			else break;
+		}
+		while(c >= '0' && c <= '9') {
+			width = width * 10 + (c - '0');
+			c = *f++;
+		}
+		if(c == '.') {
+			while((c = *f++) >= '0' && c <= '9') {
+				prec = prec * 10 + (c - '0');
+			}
+			if(prec > 9) prec = 9;
+		}
+
+		switch(c) {
+		case 'c':
+			if(!get(rec, len, &pos, 1, 0, &v)) goto short_rec;
+			buf[0] = (char)v;
+			buf[1] = 0;
+			field(0, buf, width, left, zero);
+			break;
+		case 'l':
+			if(*f == 'x') {
+				f++;
+				if(!get(rec, len, &pos, long_size, 0, &v)) goto short_rec;
+				sprintf(buf, "%0*llX", width ? 1 : 8, v & 0xFFFFFFFFULL);
+				field(0, buf, width, left, zero);
+				break;
+			}
+			// fall through
+		case 'i':
+		case 'u':
+		case 'n':
+			size = (c == 'i' || c == 'u' ? int_size : long_size);
+			if(!get(rec, len, &pos, size, c == 'i' || c == 'l', &v)) goto short_rec;
+			if(v < 0) {
+				sign = '-';
+				v    = -v;
+			}
+			fixed(buf, (unsigned long long)v, prec);
+			field(sign, buf, width, left, zero);
+			break;
+		case 'x':
+			if(!get(rec, len, &pos, int_size, 0, &v)) goto short_rec;
+			sprintf(buf, "%0*llX", width ? 1 : 4, v & 0xFFFF);
+			field(0, buf, width, left, zero);
+			break;
+		case 's':
+			// only the copy is truncated, pos must end after the '\0'
+			size = 0;
+			while(pos < len && rec[pos]) {
+				if(size < (int)sizeof(buf) - 1) {
+					buf[size++] = rec[pos];
+				}
+				pos++;
+			}
+			buf[size] = 0;
+			pos++;
+			field(0, buf, width, left, 0);
+			break;
+		case 0:
+			f--;
+			break;
+		default:
+			putchar(c);
+		}
+	}
+
+	fflush(stdout);
+	return;
+
+short_rec:
+	printf("<?>\n");
+	fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned char rec[REC_MAX];
+	int len  = 0;
+	int left = 0;
+	int zero = 0;
+	int err  = 0;
+	int b;
+
+	if(argc != 2) {
+		fprintf(stderr, "usage: %s firmware.elf < /dev/ttyUSB0\n", argv[0]);
+		return 1;
+	}
+
+	read_elf(argv[1]);
+
+	// COBS decode the frames from stdin, a zero byte ends each frame
+	while((b = getchar()) != EOF) {
+		if(b == 0) {
+			if(!err && len) {
+				print_record(rec, len);
+			}
+			len = left = zero = err = 0;
+			continue;
+		}
+
+		if(err) {
+			continue;
+		}
+
+		if(len >= REC_MAX - 1) {
+			err = 1;
+			continue;
+		}
+
+		if(left == 0) {
+			if(zero) {
+				rec[len++] = 0;
+			}
+			left = b - 1;
+			zero = (b != 0xFF);
+		} else {
+			rec[len++] = b;
+			left--;
+		}
+	}
+
+	return 0;
+}
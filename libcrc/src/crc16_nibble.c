@@ -0,0 +1,39 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "crc.h"
+
+/**
+ * CRC-16 of the index in the high nibble
+ */
+static const unsigned short crc16_nibble_table[16] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+unsigned short crc16_nibble(unsigned short crc, const unsigned char *data, unsigned short len)
+{
+	while(len--) {
+		crc = (crc << 4) ^ crc16_nibble_table[(crc >> 12) ^ (*data >> 4)];
+		crc = (crc << 4) ^ crc16_nibble_table[(crc >> 12) ^ (*data & 0x0F)];
+		data++;
+	}
+
+	return crc;
+}
@@ -0,0 +1,38 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "crc.h"
+
+unsigned long crc32_bit(unsigned long crc, const unsigned char *data, unsigned short len)
+{
+	unsigned char i;
+
+	// mask keeps the CRC at 32 bits where long is wider (host)
+	crc = ~crc & 0xFFFFFFFFUL;
+
+	while(len--) {
+		crc ^= *data++;
+
+		for(i = 0; i < 8; i++) {
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320UL : (crc >> 1);
+		}
+	}
+
+	return ~crc & 0xFFFFFFFFUL;
+}
@@ -0,0 +1,81 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libopencm3/stm32/f1/rcc.h>
+#include <libopencm3/stm32/crc.h>
+
+#include "crc.h"
+
+/**
+ * Unaligned 32 bit word (the Cortex-M3 supports unaligned loads)
+ */
+typedef struct {
+	unsigned long w;
+} __attribute__((packed)) crc32_hw_word;
+
+/**
+ * Reverse the bit order of a word.
+ */
+static inline unsigned long crc32_hw_rbit(unsigned long w)
+{
+	unsigned long r;
+
+	__asm__ ("rbit %0, %1" : "=r" (r) : "r" (w));
+
+	return r;
+}
+
+void crc32_hw_init(void)
+{
+	rcc_peripheral_enable_clock(&RCC_AHBENR, RCC_AHBENR_CRCEN);
+}
+
+unsigned long crc32_hw(const unsigned char *data, unsigned short len)
+{
+	unsigned long crc = 0xFFFFFFFFUL;
+	unsigned char i;
+
+	/*
+	 * The CRC unit calculates the not reflected CRC-32 over whole words.
+	 * Feeding it bit reversed words and reversing its result gives the
+	 * reflected CRC.
+	 */
+	if(len >= 4) {
+		CRC_CR = CRC_CR_RESET;
+
+		while(len >= 4) {
+			CRC_DR = crc32_hw_rbit(((const crc32_hw_word *)data)->w);
+			data  += 4;
+			len   -= 4;
+		}
+
+		crc = crc32_hw_rbit(CRC_DR);
+	}
+
+	/* Up to three remaining bytes are done in software. */
+	while(len--) {
+		crc ^= *data++;
+
+		for(i = 0; i < 8; i++) {
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320UL : (crc >> 1);
+		}
+	}
+
+	return ~crc;
+}
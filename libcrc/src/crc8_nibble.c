@@ -0,0 +1,39 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "crc.h"
+
+/**
+ * CRC-8 of the high nibble of the index
+ */
+static const unsigned char crc8_nibble_table[16] = {
+	0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15,
+	0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D
+};
+
+unsigned char crc8_nibble(unsigned char crc, const unsigned char *data, unsigned short len)
+{
+	while(len--) {
+		crc ^= *data++;
+		crc  = (crc << 4) ^ crc8_nibble_table[crc >> 4];
+		crc  = (crc << 4) ^ crc8_nibble_table[crc >> 4];
+	}
+
+	return crc;
+}
@@ -0,0 +1,165 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CRC_H_
+#define __CRC_H_
+
+/*
+ * Three variants are provided for each CRC, trading flash for speed:
+ *
+ * crcN_bit     bitwise, no table
+ * crcN_nibble  16 entry table (16/32/64 bytes for CRC-8/16/32)
+ * crcN_byte    256 entry table (256/512/1024 bytes for CRC-8/16/32)
+ *
+ * All variants of a CRC give the same result. Each variant lives in its
+ * own object, thus only the tables of the variants used are linked.
+ */
+
+/**
+ * Start value for CRC-8 (poly 0x07, init 0x00, not reflected, no final XOR).
+ */
+#define CRC8_INIT		0x00
+
+/**
+ * Start value for CRC-16 (CCITT: poly 0x1021, init 0xFFFF, not reflected,
+ * no final XOR).
+ */
+#define CRC16_INIT		0xFFFF
+
+/**
+ * Start value for CRC-32 (IEEE 802.3: poly 0x04C11DB7, reflected, init and
+ * final XOR 0xFFFFFFFF, applied internally as done by zlib).
+ */
+#define CRC32_INIT		0x00000000
+
+/**
+ * Calculate CRC-8 bitwise.
+ *
+ * @param[in]	crc		CRC8_INIT, or the result of the previous call to continue
+ * @param[in]	*data	data to calculate the CRC for
+ * @param[in]	len		number of bytes in data
+ * @return				CRC of all the data so far
+ */
+unsigned char crc8_bit(unsigned char crc, const unsigned char *data, unsigned short len);
+
+/**
+ * Calculate CRC-8 using a 16 entry table. See {@link crc8_bit}.
+ *
+ * @param[in]	crc		CRC8_INIT, or the result of the previous call to continue
+ * @param[in]	*data	data to calculate the CRC for
+ * @param[in]	len		number of bytes in data
+ * @return				CRC of all the data so far
+ */
+unsigned char crc8_nibble(unsigned char crc, const unsigned char *data, unsigned short len);
+
+/**
+ * Calculate CRC-8 using a 256 entry table. See {@link crc8_bit}.
+ *
+ * @param[in]	crc		CRC8_INIT, or the result of the previous call to continue
+ * @param[in]	*data	data to calculate the CRC for
+ * @param[in]	len		number of bytes in data
+ * @return				CRC of all the data so far
+ */
+unsigned char crc8_byte(unsigned char crc, const unsigned char *data, unsigned short len);
+
+/**
+ * Calculate CRC-16 bitwise.
+ *
+ * @param[in]	crc		CRC16_INIT, or the result of the previous call to continue
+ * @param[in]	*data	data to calculate the CRC for
+ * @param[in]	len		number of bytes in data
+ * @return				CRC of all the data so far
+ */
+unsigned short crc16_bit(unsigned short crc, const unsigned char *data, unsigned short len);
+
+/**
+ * Calculate CRC-16 using a 16 entry table. See {@link crc16_bit}.
+ *
+ * @param[in]	crc		CRC16_INIT, or the result of the previous call to continue
+ * @param[in]	*data	data to calculate the CRC for
+ * @param[in]	len		number of bytes in data
+ * @return				CRC of all the data so far
+ */
+unsigned short crc16_nibble(unsigned short crc, const unsigned char *data, unsigned short len);
+
+/**
+ * Calculate CRC-16 using a 256 entry table. See {@link crc16_bit}.
+ *
+ * @param[in]	crc		CRC16_INIT, or the result of the previous call to continue
+ * @param[in]	*data	data to calculate the CRC for
+ * @param[in]	len		number of bytes in data
+ * @return				CRC of all the data so far
+ */
+unsigned short crc16_byte(unsigned short crc, const unsigned char *data, unsigned short len);
+
+/**
+ * Calculate CRC-32 bitwise.
+ *
+ * @param[in]	crc		CRC32_INIT, or the result of the previous call to continue
+ * @param[in]	*data	data to calculate the CRC for
+ * @param[in]	len		number of bytes in data
+ * @return				CRC of all the data so far
+ */
+unsigned long crc32_bit(unsigned long crc, const unsigned char *data, unsigned short len);
+
+/**
+ * Calculate CRC-32 using a 16 entry table. See {@link crc32_bit}.
+ *
+ * @param[in]	crc		CRC32_INIT, or the result of the previous call to continue
+ * @param[in]	*data	data to calculate the CRC for
+ * @param[in]	len		number of bytes in data
+ * @return				CRC of all the data so far
+ */
+unsigned long crc32_nibble(unsigned long crc, const unsigned char *data, unsigned short len);
+
+/**
+ * Calculate CRC-32 using a 256 entry table. See {@link crc32_bit}.
+ *
+ * @param[in]	crc		CRC32_INIT, or the result of the previous call to continue
+ * @param[in]	*data	data to calculate the CRC for
+ * @param[in]	len		number of bytes in data
+ * @return				CRC of all the data so far
+ */
+unsigned long crc32_byte(unsigned long crc, const unsigned char *data, unsigned short len);
+
+#ifndef MSP430
+#ifndef HOST
+
+/**
+ * Enable the clock of the CRC unit of the STM32. Must be called once
+ * before using {@link crc32_hw}.
+ */
+void crc32_hw_init(void);
+
+/**
+ * Calculate CRC-32 using the CRC unit of the STM32 (STM32 only). Gives the
+ * same result as {@link crc32_bit}, but since the CRC unit could not be
+ * loaded with a start value, a CRC could not be continued: the CRC is always
+ * calculated over the given data only.
+ *
+ * @param[in]	*data	data to calculate the CRC for
+ * @param[in]	len		number of bytes in data
+ * @return				CRC of the data
+ */
+unsigned long crc32_hw(const unsigned char *data, unsigned short len);
+
+#endif
+#endif
+
+#endif
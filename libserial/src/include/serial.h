@@ -20,12 +20,38 @@
 #ifndef __SERIAL_H_
 #define __SERIAL_H_
 
+/**
+ * Handle of a serial port.
+ */
+typedef unsigned char serial_port;
+
+/**
+ * First serial port: USART1 on the STM32, USCI_A0 on the MSP430. This is
+ * the default USART used by the serial_* functions without port handle.
+ */
+#define SERIAL_PORT1		0
+
+/**
+ * Second serial port: USART2 on the STM32 (not available on the MSP430G2553).
+ */
+#define SERIAL_PORT2		1
+
+/**
+ * Third serial port: USART3 on the STM32 (not available on the MSP430G2553).
+ */
+#define SERIAL_PORT3		2
+
+/**
+ * Number of serial ports supported.
+ */
+#define SERIAL_PORTS		3
+
 /**
  * Initialize the default USART with the given baudrate.
  *
  * @param[in]	baudrate	the baudrate of the USART
  */
-void serial_init(unsigned int baudrate);
+void serial_init(unsigned long baudrate);
 
 /**
  * Initialize the default USART for given CLK speed with 
@@ -34,7 +60,15 @@ void serial_init(unsigned int baudrate);
  * @param[in]	clkspeed	the speed of the CLK for the USART 
  * @param[in]	baudrate	the baudrate of the USART
  */
-void serial_clk_init(long clkspeed, unsigned int baudrate);
+void serial_clk_init(long clkspeed, unsigned long baudrate);
+
+/**
+ * Error of the baudrate actually set up for the default USART against
+ * the requested baudrate.
+ *
+ * @return	error in 1/100 percent (e.g. -7 for -0.07%)
+ */
+int serial_baud_error();
 
 /**
  * Send a byte non-blocking through the default USART.
@@ -65,4 +99,64 @@ unsigned char serial_recv();
  */
 unsigned char serial_recv_blocking();
 
+/**
+ * Initialize the given serial port with the given baudrate.
+ *
+ * @param[in]	port		the port to initialize (SERIAL_PORT*)
+ * @param[in]	baudrate	the baudrate of the port
+ */
+void serial_port_init(serial_port port, unsigned long baudrate);
+
+/**
+ * Initialize the given serial port for given CLK speed with 
+ * given baudrate.
+ *
+ * @param[in]	port		the port to initialize (SERIAL_PORT*)
+ * @param[in]	clkspeed	the speed of the CLK for the port 
+ * @param[in]	baudrate	the baudrate of the port
+ */
+void serial_port_clk_init(serial_port port, long clkspeed, unsigned long baudrate);
+
+/**
+ * Error of the baudrate actually set up for the given serial port
+ * against the requested baudrate.
+ *
+ * @param[in]	port	the port to query
+ * @return				error in 1/100 percent (e.g. -7 for -0.07%)
+ */
+int serial_port_baud_error(serial_port port);
+
+/**
+ * Send a byte non-blocking through the given serial port.
+ *
+ * @param[in]	port	the port to send through
+ * @param[in]	data	byte to send
+ */
+void serial_port_send(serial_port port, unsigned char data);
+
+/**
+ * Send a byte blocking through the given serial port.
+ *
+ * @param[in]	port	the port to send through
+ * @param[in]	data	byte to send
+ */
+void serial_port_send_blocking(serial_port port, unsigned char data);
+
+/**
+ * Receive a byte non-blocking from the given serial port (makes
+ * only sense when used in an ISR).
+ *
+ * @param[in]	port	the port to receive from
+ * @return	byte received
+ */
+unsigned char serial_port_recv(serial_port port);
+
+/**
+ * Receive a byte blocking from the given serial port.
+ *
+ * @param[in]	port	the port to receive from
+ * @return	byte received
+ */
+unsigned char serial_port_recv_blocking(serial_port port);
+
 #endif
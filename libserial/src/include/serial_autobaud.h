@@ -0,0 +1,69 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERIAL_AUTOBAUD_H_
+#define __SERIAL_AUTOBAUD_H_
+
+/**
+ * Sync character the host has to send for baudrate detection ('U'). On the
+ * line, it gives a falling edge every two bit times.
+ */
+#define SERIAL_AUTOBAUD_SYNC	0x55
+
+/**
+ * Detect the baudrate of the host and initialize the default USART with
+ * it (STM32 and MSP430 only). Blocks until the host sent a
+ * {@link SERIAL_AUTOBAUD_SYNC} character. The time between the falling edges
+ * of the sync character is measured by a timer capture on the RX pin:
+ * TIM1 channel 3 (PA10) on the STM32, Timer0_A capture 0 (P1.1) on the
+ * MSP430. The timer is stopped again afterwards.
+ * <br/>
+ * Since the sync character is periodic, the host could send it repeatedly
+ * until the firmware answers. Bytes received until the USART is enabled
+ * are lost.
+ *
+ * @param[in]	clkspeed	clock of the USART (see {@link serial_clk_init})
+ * @return					the baudrate detected
+ */
+unsigned long serial_autobaud_init(long clkspeed);
+
+/**
+ * Calculate the baudrate from a measured time. The result is rounded to
+ * the nearest standard baudrate (1200 to 921600), if it is within 5% of it.
+ *
+ * @param[in]	clk			clock of the timer used for measuring in Hz
+ * @param[in]	ticks		timer ticks for 8 bit times
+ * @return					the baudrate
+ */
+unsigned long serial_autobaud_rate(unsigned long clk, unsigned long ticks);
+
+/**
+ * Measure the time of 8 bit times from the falling edges of the sync
+ * character, used by the backends of {@link serial_autobaud_init}. Four
+ * consecutive edge periods must match within 1/8, otherwise the window
+ * slides on by one edge, until it lines up with one sync character.
+ *
+ * @param[in]	edge		waits for the next falling edge on RX and returns
+ * 							its 16 bit timer capture
+ * @return					timer ticks for 8 bit times (see
+ * 							{@link serial_autobaud_rate})
+ */
+unsigned long serial_autobaud_measure(unsigned short (*edge)(void));
+
+#endif
@@ -0,0 +1,178 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERIAL_COBS_H_
+#define __SERIAL_COBS_H_
+
+#include "serial_rb.h"
+
+/**
+ * Max. number of bytes in a COBS block (code byte included).
+ */
+#define SERIAL_COBS_BLOCK	0xFF
+
+/**
+ * State of a streaming COBS encoder. The encoded frame is written directly
+ * into the memory of a ringbuffer (e.g. the TX ringbuffer passed to
+ * serial_irq_init). The bytes of a block are published to the ringbuffer
+ * as soon as its code byte is known, that is, when the block is complete.
+ */
+typedef struct {
+	/**
+ 	 * Ringbuffer the encoded frame is written to
+ 	 */
+	serial_rb *rb;
+
+	/**
+ 	 * Write position of the next byte (not yet published)
+ 	 */
+	unsigned short pos;
+
+	/**
+ 	 * Position of the code byte of the current block
+ 	 */
+	unsigned short code_pos;
+
+	/**
+ 	 * Code of the current block (number of data bytes + 1)
+ 	 */
+	unsigned char code;
+} serial_cobs_enc;
+
+/**
+ * State of a streaming COBS decoder. Bytes could be fed one by one (e.g.
+ * from the RX ISR) or directly from a ringbuffer. The frame is decoded into
+ * the given buffer, a zero byte ends the frame (and resynchronizes the
+ * decoder after an error).
+ */
+typedef struct {
+	/**
+ 	 * Buffer for the decoded frame
+ 	 */
+	unsigned char *frame;
+
+	/**
+ 	 * Size of the frame buffer
+ 	 */
+	unsigned short size;
+
+	/**
+ 	 * Number of bytes decoded so far
+ 	 */
+	unsigned short len;
+
+	/**
+ 	 * Number of data bytes left in the current block (0 = next byte is a code)
+ 	 */
+	unsigned char left;
+
+	/**
+ 	 * 1 if a zero has to be inserted before the next block
+ 	 */
+	unsigned char zero;
+
+	/**
+ 	 * 1 if the current frame is broken, bytes are skipped until its end
+ 	 */
+	unsigned char error;
+} serial_cobs_dec;
+
+/**
+ * Initialize an encoder writing to the given ringbuffer.
+ * <br/>
+ * Note: a block is only published when it is complete, thus the
+ * ringbuffer must be able to hold at least one block (256 bytes) for frames
+ * of more than 254 bytes.
+ *
+ * @param[out]	*enc	the encoder
+ * @param[in]	*rb		ringbuffer to write encoded frames to
+ */
+void serial_cobs_enc_init(serial_cobs_enc *enc, serial_rb *rb);
+
+/**
+ * Start a new frame.
+ *
+ * @param[in]	*enc	the encoder
+ * @return				0 on success, -1 if the ringbuffer is full
+ */
+int serial_cobs_enc_begin(serial_cobs_enc *enc);
+
+/**
+ * Add a byte to the current frame.
+ *
+ * @param[in]	*enc	the encoder
+ * @param[in]	data	byte to add
+ * @return				0 on success, -1 if the ringbuffer is full (the byte was
+ * 						not added, retry when the ringbuffer has room)
+ */
+int serial_cobs_enc_put(serial_cobs_enc *enc, unsigned char data);
+
+/**
+ * Add up to len bytes to the current frame.
+ *
+ * @param[in]	*enc	the encoder
+ * @param[in]	*data	bytes to add
+ * @param[in]	len		number of bytes to add
+ * @return				number of bytes added (less than len if the
+ * 						ringbuffer is full)
+ */
+unsigned short serial_cobs_enc_write(serial_cobs_enc *enc, const unsigned char *data, unsigned short len);
+
+/**
+ * End the current frame: publish the last block and the frame delimiter.
+ *
+ * @param[in]	*enc	the encoder
+ * @return				0 on success, -1 if the ringbuffer is full (retry)
+ */
+int serial_cobs_enc_end(serial_cobs_enc *enc);
+
+/**
+ * Initialize a decoder.
+ *
+ * @param[out]	*dec	the decoder
+ * @param[in]	*frame	buffer for decoded frames
+ * @param[in]	size	size of the frame buffer
+ */
+void serial_cobs_dec_init(serial_cobs_dec *dec, unsigned char *frame, unsigned short size);
+
+/**
+ * Feed one received byte to the decoder. When a frame is returned, it is
+ * valid in the frame buffer until the next byte is fed. Empty frames are
+ * ignored.
+ *
+ * @param[in]	*dec	the decoder
+ * @param[in]	data	byte received
+ * @return				length of the frame completed by this byte, 0 if the
+ * 						frame is not complete yet, -1 if a broken frame (bad
+ * 						encoding or too long for the buffer) ended
+ */
+int serial_cobs_dec_put(serial_cobs_dec *dec, unsigned char data);
+
+/**
+ * Feed the bytes queued in a ringbuffer to the decoder, up to the end of the
+ * next frame. The bytes are decoded directly from the ringbuffers memory and
+ * consumed.
+ *
+ * @param[in]	*dec	the decoder
+ * @param[in]	*rb		ringbuffer holding received bytes
+ * @return				see {@link serial_cobs_dec_put}
+ */
+int serial_cobs_dec_rb(serial_cobs_dec *dec, serial_rb *rb);
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERIAL_DMA_H_
+#define __SERIAL_DMA_H_
+
+#include "serial_rb.h"
+
+/**
+ * Initialize DMA driven transmission on the default USART (STM32 only,
+ * uses DMA1 channel 4). The USART must have been initialized by
+ * {@link serial_init} or {@link serial_clk_init} before.
+ */
+void serial_dma_init(void);
+
+/**
+ * Set a function to be called (from the DMA ISR) each time a transfer
+ * started by {@link serial_dma_send} completed.
+ *
+ * @param[in]	*done	callback function (NULL for none)
+ */
+void serial_dma_set_callback(void (*done)(void));
+
+/**
+ * Check if a DMA transfer is in progress.
+ *
+ * @return	1 if busy, 0 otherwise
+ */
+int serial_dma_busy(void);
+
+/**
+ * Start sending len bytes from data through the default USART by DMA. The
+ * function returns immediately, the data must stay untouched until the
+ * transfer completed (see {@link serial_dma_busy} and
+ * {@link serial_dma_set_callback}). For ping-pong operation, fill one
+ * buffer while the other one is sent.
+ *
+ * @param[in]	*data	bytes to send
+ * @param[in]	len		number of bytes to send
+ * @return				0 if transfer was started, -1 if DMA is busy
+ */
+int serial_dma_send(const unsigned char *data, unsigned short len);
+
+/**
+ * Send the contents of a ringbuffer through the default USART by DMA.
+ * The queued elements are handed to the DMA in place (no copy) and
+ * consumed when transferred. When a transfer completes, the DMA ISR
+ * continues with whatever was added to the ringbuffer in the meantime,
+ * until it is empty. After writing to the ringbuffer, call this function
+ * again to restart the DMA if it went idle.
+ *
+ * @param		*rb		ringbuffer to drain (the DMA is its only consumer)
+ * @return				0 if DMA was started or is already draining rb, -1 if
+ * 						DMA is busy with a transfer from {@link serial_dma_send}
+ */
+int serial_dma_send_rb(serial_rb *rb);
+
+/**
+ * Initialize DMA driven reception on the default USART (STM32 only, uses
+ * DMA1 channel 5). The DMA writes received bytes directly and circularly into
+ * the memory of the given ringbuffer. The bytes are made visible to the
+ * consumer on half/full transfer and when the line goes idle after a burst,
+ * thus a burst costs one interrupt instead of one per byte. Received bytes are
+ * read with the normal ringbuffer functions ({@link serial_rb_read},
+ * {@link serial_rb_read_block}, {@link serial_rb_peek}).
+ * <br/>
+ * Since the DMA could not be stopped when the ringbuffer is full, the policy
+ * of the ringbuffer is set to SERIAL_RB_POLICY_OVERWRITE (lost bytes are
+ * counted in the stats of the ringbuffer).
+ * <br/>
+ * Note: the idle line is handled by the same USART1 ISR as used by
+ * {@link serial_irq_init}, thus the application must not define its own.
+ * Since received bytes go to the DMA, pass no RX ringbuffer to
+ * {@link serial_irq_init} when using both.
+ *
+ * @param		*rb		ringbuffer to receive into (the DMA is its producer)
+ */
+void serial_dma_rx_init(serial_rb *rb);
+
+#endif
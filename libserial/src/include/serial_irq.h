@@ -0,0 +1,259 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERIAL_IRQ_H_
+#define __SERIAL_IRQ_H_
+
+#include "serial.h"
+#include "serial_rb.h"
+
+/**
+ * State of the RTS/CTS flow control of a serial port.
+ */
+typedef struct {
+	/**
+ 	 * RX ringbuffer level at which RTS is deasserted (0 = flow control off)
+ 	 */
+	unsigned short hwm;
+
+	/**
+ 	 * RX ringbuffer level at which RTS is asserted again
+ 	 */
+	unsigned short lwm;
+
+	/**
+ 	 * 1 if RTS is currently deasserted (sender asked to pause)
+ 	 */
+	volatile unsigned char stopped;
+} serial_flow;
+
+/**
+ * Initialize interrupt driven communication on the default USART. After this,
+ * the RX/TX ISRs of the default USART are owned by libserial: received
+ * bytes are put into the RX ringbuffer, bytes from the TX ringbuffer are sent
+ * out in the background. The USART must have been initialized by
+ * {@link serial_init} or {@link serial_clk_init} before.
+ * <br/>
+ * Note: the application must not define ISRs for the default USART when
+ * using this (on the MSP430, the USCI_A0 vectors are shared with USCI_B0,
+ * thus interrupt driven I2C from libi2c could not be used at the same time).
+ *
+ * @param		*rx		ringbuffer for received bytes (NULL for TX only)
+ * @param		*tx		ringbuffer for bytes to send (NULL for RX only)
+ */
+void serial_irq_init(serial_rb *rx, serial_rb *tx);
+
+/**
+ * Queue up to len bytes for sending through the default USART. Never
+ * blocks: only the bytes fitting into the TX ringbuffer are queued.
+ *
+ * @param[in]	*data	bytes to send
+ * @param[in]	len		number of bytes to send
+ * @return				number of bytes queued
+ */
+unsigned short serial_write(const unsigned char *data, unsigned short len);
+
+/**
+ * Read up to len received bytes from the default USART. Never blocks:
+ * only the bytes already in the RX ringbuffer are returned.
+ *
+ * @param[out]	*data	where to store the bytes read
+ * @param[in]	len		max. number of bytes to read
+ * @return				number of bytes read
+ */
+unsigned short serial_read(unsigned char *data, unsigned short len);
+
+/**
+ * Receive a byte from the default USART, blocking until one is available.
+ * Unlike {@link serial_recv_blocking}, the CPU is put to sleep (LPM0 on the
+ * MSP430, WFI on the STM32) until the RX interrupt delivered a byte into the
+ * RX ringbuffer. Requires {@link serial_irq_init} with a RX ringbuffer.
+ *
+ * @return	byte received
+ */
+unsigned char serial_recv_sleep();
+
+/**
+ * Send a byte through the default USART, blocking while the TX ringbuffer
+ * is full. Unlike {@link serial_send_blocking}, the CPU is put to sleep
+ * until the TX interrupt made room in the TX ringbuffer. Requires
+ * {@link serial_irq_init} with a TX ringbuffer.
+ *
+ * @param[in]	data	byte to send
+ */
+void serial_send_sleep(unsigned char data);
+
+/**
+ * Receive a byte from the default USART, waiting at most ms milliseconds
+ * for it. The CPU sleeps while waiting. Requires {@link serial_irq_init}
+ * with a RX ringbuffer and the time base started by {@link serial_time_init}.
+ *
+ * @param[in]	ms		timeout in milliseconds
+ * @return				byte received, -1 on timeout
+ */
+int serial_recv_timeout(unsigned short ms);
+
+/**
+ * Read len bytes from the default USART, waiting at most ms milliseconds
+ * for them. See {@link serial_recv_timeout}.
+ *
+ * @param[out]	*data	where to store the bytes read
+ * @param[in]	len		number of bytes to read
+ * @param[in]	ms		timeout in milliseconds
+ * @return				number of bytes read (less than len on timeout)
+ */
+unsigned short serial_read_timeout(unsigned char *data, unsigned short len, unsigned short ms);
+
+/**
+ * Queue len bytes for sending through the default USART, waiting at most
+ * ms milliseconds for room in the TX ringbuffer. See {@link serial_recv_timeout}.
+ *
+ * @param[in]	*data	bytes to send
+ * @param[in]	len		number of bytes to send
+ * @param[in]	ms		timeout in milliseconds
+ * @return				number of bytes queued (less than len on timeout)
+ */
+unsigned short serial_write_timeout(const unsigned char *data, unsigned short len, unsigned short ms);
+
+/**
+ * Initialize interrupt driven communication on the given serial port. See
+ * {@link serial_irq_init} for details. Each port uses its own ringbuffers,
+ * thus multiple ports could be used in parallel.
+ * <br/>
+ * Note: on the STM32, libserial owns the ISRs of all USARTs when using
+ * this.
+ *
+ * @param[in]	port	the port (SERIAL_PORT*)
+ * @param		*rx		ringbuffer for received bytes (NULL for TX only)
+ * @param		*tx		ringbuffer for bytes to send (NULL for RX only)
+ */
+void serial_port_irq_init(serial_port port, serial_rb *rx, serial_rb *tx);
+
+/**
+ * Queue up to len bytes for sending through the given serial port. See
+ * {@link serial_write}.
+ *
+ * @param[in]	port	the port (SERIAL_PORT*)
+ * @param[in]	*data	bytes to send
+ * @param[in]	len		number of bytes to send
+ * @return				number of bytes queued
+ */
+unsigned short serial_port_write(serial_port port, const unsigned char *data, unsigned short len);
+
+/**
+ * Read up to len received bytes from the given serial port. See
+ * {@link serial_read}.
+ *
+ * @param[in]	port	the port (SERIAL_PORT*)
+ * @param[out]	*data	where to store the bytes read
+ * @param[in]	len		max. number of bytes to read
+ * @return				number of bytes read
+ */
+unsigned short serial_port_read(serial_port port, unsigned char *data, unsigned short len);
+
+/**
+ * Receive a byte from the given serial port, sleeping until one is
+ * available. See {@link serial_recv_sleep}.
+ *
+ * @param[in]	port	the port (SERIAL_PORT*)
+ * @return				byte received
+ */
+unsigned char serial_port_recv_sleep(serial_port port);
+
+/**
+ * Send a byte through the given serial port, sleeping while the TX
+ * ringbuffer is full. See {@link serial_send_sleep}.
+ *
+ * @param[in]	port	the port (SERIAL_PORT*)
+ * @param[in]	data	byte to send
+ */
+void serial_port_send_sleep(serial_port port, unsigned char data);
+
+/**
+ * Receive a byte from the given serial port, waiting at most ms
+ * milliseconds. See {@link serial_recv_timeout}.
+ *
+ * @param[in]	port	the port (SERIAL_PORT*)
+ * @param[in]	ms		timeout in milliseconds
+ * @return				byte received, -1 on timeout
+ */
+int serial_port_recv_timeout(serial_port port, unsigned short ms);
+
+/**
+ * Read len bytes from the given serial port, waiting at most ms
+ * milliseconds. See {@link serial_read_timeout}.
+ *
+ * @param[in]	port	the port (SERIAL_PORT*)
+ * @param[out]	*data	where to store the bytes read
+ * @param[in]	len		number of bytes to read
+ * @param[in]	ms		timeout in milliseconds
+ * @return				number of bytes read (less than len on timeout)
+ */
+unsigned short serial_port_read_timeout(serial_port port, unsigned char *data, unsigned short len, unsigned short ms);
+
+/**
+ * Queue len bytes for sending through the given serial port, waiting at
+ * most ms milliseconds. See {@link serial_write_timeout}.
+ *
+ * @param[in]	port	the port (SERIAL_PORT*)
+ * @param[in]	*data	bytes to send
+ * @param[in]	len		number of bytes to send
+ * @param[in]	ms		timeout in milliseconds
+ * @return				number of bytes queued (less than len on timeout)
+ */
+unsigned short serial_port_write_timeout(serial_port port, const unsigned char *data, unsigned short len, unsigned short ms);
+
+/**
+ * Enable RTS/CTS hardware flow control on the default USART. Must be
+ * called after {@link serial_irq_init}. See {@link serial_port_flow_init}.
+ *
+ * @param[in]	hwm		RX ringbuffer level at which RTS is deasserted
+ * @param[in]	lwm		RX ringbuffer level at which RTS is asserted again
+ */
+void serial_flow_init(unsigned short hwm, unsigned short lwm);
+
+/**
+ * Enable RTS/CTS hardware flow control on the given serial port. Must be
+ * called after {@link serial_port_irq_init}.
+ * <br/>
+ * RTS is deasserted by the RX ISR as soon as the RX ringbuffer holds hwm or
+ * more bytes, and asserted again by {@link serial_port_read} when the
+ * level dropped to lwm or below. Choose hwm low enough to leave room for the
+ * bytes the sender transmits before reacting to RTS.
+ * <br/>
+ * On the STM32, CTS is evaluated by the USART (transmission pauses while CTS
+ * is deasserted). Pins: USART1 CTS/RTS PA11/PA12, USART2 PA0/PA1, USART3
+ * PB13/PB14 (conflicts with SPI2). On the MSP430, only RTS is supported, it
+ * is driven on P2.0 (override by defining SERIAL_RTS when building libserial).
+ *
+ * @param[in]	port	the port (SERIAL_PORT*)
+ * @param[in]	hwm		RX ringbuffer level at which RTS is deasserted
+ * @param[in]	lwm		RX ringbuffer level at which RTS is asserted again
+ */
+void serial_port_flow_init(serial_port port, unsigned short hwm, unsigned short lwm);
+
+/**
+ * Re-evaluate the RTS state of the given port. Only needs to be called if
+ * the RX ringbuffer is read directly (instead of using {@link serial_port_read}).
+ *
+ * @param[in]	port	the port (SERIAL_PORT*)
+ */
+void serial_port_flow_update(serial_port port);
+
+#endif
@@ -0,0 +1,101 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERIAL_NEGOTIATE_H_
+#define __SERIAL_NEGOTIATE_H_
+
+#include "serial.h"
+
+/**
+ * Baudrate both ends start with and fall back to.
+ */
+#define SERIAL_NEGOTIATE_BAUD		9600
+
+/**
+ * Timeout (in ms) for each step of the handshake.
+ */
+#define SERIAL_NEGOTIATE_TIMEOUT	100
+
+/**
+ * Max. baudrate error (in 1/100 percent) accepted for a negotiated
+ * baudrate.
+ */
+#define SERIAL_NEGOTIATE_MAX_ERR	200
+
+/**
+ * Negotiate the highest baudrate supported by both ends of the default
+ * USART, as the initiating end (master). See {@link serial_port_negotiate_master}.
+ *
+ * @param[in]	clkspeed	clock of the USART (see {@link serial_clk_init})
+ * @param[in]	max			highest baudrate to offer
+ * @return					the baudrate now used
+ */
+unsigned long serial_negotiate_master(long clkspeed, unsigned long max);
+
+/**
+ * Wait for the master to negotiate the baudrate of the default USART.
+ * See {@link serial_port_negotiate_slave}.
+ *
+ * @param[in]	clkspeed	clock of the USART (see {@link serial_clk_init})
+ * @param[in]	max			highest baudrate to accept
+ * @param[in]	ms			time to wait for the master in ms
+ * @return					the baudrate now used
+ */
+unsigned long serial_negotiate_slave(long clkspeed, unsigned long max, unsigned short ms);
+
+/**
+ * Negotiate the highest baudrate supported by both ends of the given
+ * serial port, as the initiating end (master).
+ * <br/>
+ * Both ends must run at SERIAL_NEGOTIATE_BAUD with interrupt driven
+ * communication ({@link serial_port_irq_init}) and the time base
+ * ({@link serial_time_init}) started. The master offers its highest
+ * baudrate, the slave answers with the highest standard baudrate (9600
+ * to 921600) both support. Then both switch to it, and a test pattern is
+ * sent to the slave and echoed back, the master confirms it and the slave
+ * acknowledges the confirmation. If this fails (or the baudrate error
+ * of one end is above SERIAL_NEGOTIATE_MAX_ERR), both fall back to
+ * SERIAL_NEGOTIATE_BAUD and the next lower baudrate is tried. If only the
+ * acknowledgment is lost, the master ends up at SERIAL_NEGOTIATE_BAUD.
+ * <br/>
+ * The link must be idle while negotiating, all bytes received are
+ * discarded.
+ *
+ * @param[in]	port		the port (SERIAL_PORT*)
+ * @param[in]	clkspeed	clock of the port (see {@link serial_port_clk_init})
+ * @param[in]	max			highest baudrate to offer
+ * @return					the baudrate now used (SERIAL_NEGOTIATE_BAUD if the
+ * 							slave did not answer)
+ */
+unsigned long serial_port_negotiate_master(serial_port port, long clkspeed, unsigned long max);
+
+/**
+ * Wait for the master to negotiate the baudrate of the given serial port.
+ * See {@link serial_port_negotiate_master}.
+ *
+ * @param[in]	port		the port (SERIAL_PORT*)
+ * @param[in]	clkspeed	clock of the port (see {@link serial_port_clk_init})
+ * @param[in]	max			highest baudrate to accept
+ * @param[in]	ms			time to wait for the master in ms
+ * @return					the baudrate now used (SERIAL_NEGOTIATE_BAUD if the
+ * 							master did not negotiate in time)
+ */
+unsigned long serial_port_negotiate_slave(serial_port port, long clkspeed, unsigned long max, unsigned short ms);
+
+#endif
@@ -25,8 +25,62 @@
  */
 #define SERIAL_RB_Q         unsigned char
 
+/**
+ * Compiler barrier. Makes sure accesses to the buffer memory are not
+ * reordered across updates of the read/write index. On the host, producer
+ * and consumer may run on different CPUs, thus a full memory barrier is used.
+ */
+#ifdef HOST
+#define SERIAL_RB_BARRIER()	__sync_synchronize()
+#else
+#define SERIAL_RB_BARRIER()	__asm__ __volatile__("" ::: "memory")
+#endif
+
+/**
+ * Overflow policy: drop the new element if the buffer is full.
+ */
+#define SERIAL_RB_POLICY_DROP		0
+
+/**
+ * Overflow policy: overwrite the oldest element if the buffer is full.
+ */
+#define SERIAL_RB_POLICY_OVERWRITE	1
+
+/**
+ * Overflow policy: reject the new element if the buffer is full and
+ * report this to the caller.
+ */
+#define SERIAL_RB_POLICY_REJECT		2
+
+/**
+ * Occupancy statistics of a ringbuffer.
+ */
+typedef struct {
+	/**
+ 	 * Max. number of elements which were queued at the same time.
+ 	 */
+	unsigned short hwm;
+
+	/**
+ 	 * Total number of elements written to the buffer.
+ 	 */
+	unsigned long enqueued;
+
+	/**
+ 	 * Total number of elements lost due to overflow (dropped,
+ 	 * overwritten or rejected).
+ 	 */
+	unsigned long dropped;
+} serial_rb_stats;
+
 /**
  * Definiton of a ringbuffer.
+ * <br/>
+ * The ringbuffer is lock-free for exactly one producer and one consumer
+ * (e.g. an ISR writing and the main loop reading): the producer only modifies
+ * the write index, the consumer only modifies the read index. Both indices
+ * are free running and masked on access, thus the number of elements must be
+ * a power of two.
  */
 typedef struct {
 	/**
@@ -35,14 +89,14 @@ typedef struct {
     SERIAL_RB_Q *buffer;
 
 	/**
- 	 * Pointer to the current read position within the buffer.
+ 	 * Free running read index (only modified by the consumer).
  	 */
-    SERIAL_RB_Q *read;
+    volatile unsigned short read;
 
 	/**
- 	 * Pointer to the current write position within the buffer.
+ 	 * Free running write index (only modified by the producer).
  	 */
-    SERIAL_RB_Q *write;
+    volatile unsigned short write;
 
 	/**
  	 * Max. number of elements that fit into buffer (buffer size). 
@@ -50,11 +104,28 @@ typedef struct {
     unsigned short elements;
 
 	/**
- 	 * Number of elements currently queued in the buffer.
+ 	 * Mask applied to the indices (elements - 1).
  	 */
-    unsigned short entries;
+    unsigned short mask;
+
+	/**
+ 	 * Overflow policy used by {@link serial_rb_put} (SERIAL_RB_POLICY_*).
+ 	 */
+    unsigned char policy;
+
+	/**
+ 	 * Occupancy statistics (only modified by the producer). 
+ 	 */
+    serial_rb_stats stats;
 } serial_rb;
 
+/**
+ * Return the number of elements currently queued in a given buffer.
+ *
+ * @return	number of elements in the buffer
+ */
+unsigned short serial_rb_used(serial_rb *rb);
+
 /**
  * Return the number of free elements in a given buffer.
  *
@@ -78,30 +149,187 @@ int serial_rb_empty(serial_rb *rb);
 
 /**
  * Initialize a given ringbuffer by assigning the given buffer with the number
- * of given elements.
+ * of given elements. The number of elements must be a power of two (max. 32768),
+ * if it is not, only the largest power of two fitting into the buffer is used.
+ * A buffer for 0 elements is invalid, the buffer is then used for 1 element.
  *
  * @param		*rb			the ringbuffer to initialize
  * @param[in]	*buffer		the buffer to assign to this rb (must be allocated!)
  * @param[in]	elements	number of elements which could be stored in buffer
+ * 							(at least 1)
  */
 void serial_rb_init(serial_rb *rb, SERIAL_RB_Q *buffer, unsigned short elements);
 
 /**
  * Write a given element to a given buffer. Check if buffer has space left
  * before adding a new element with {@link serial_rb_full).
+ * <br/>
+ * Must only be called by the producer.
  *
  * @param		*rb			the ringbuffer to initialize
  * @param[in]	element		the element to add
  */
 void serial_rb_write(serial_rb *rb, SERIAL_RB_Q element);
 
+/**
+ * Write a given element to a given buffer, applying the overflow policy
+ * of the buffer if it is full (see {@link serial_rb_set_policy}). Unlike
+ * {@link serial_rb_write}, no check for a full buffer is needed before.
+ * <br/>
+ * Must only be called by the producer.
+ *
+ * @param		*rb			the ringbuffer to write to
+ * @param[in]	element		the element to add
+ * @return					0 if the element was added, -1 if it was rejected
+ * 							(only with SERIAL_RB_POLICY_REJECT)
+ */
+int serial_rb_put(serial_rb *rb, SERIAL_RB_Q element);
+
+/**
+ * Set the overflow policy used by {@link serial_rb_put} for a given buffer.
+ * The default policy after {@link serial_rb_init} is SERIAL_RB_POLICY_DROP.
+ * <br/>
+ * With SERIAL_RB_POLICY_OVERWRITE, the producer never touches the read index.
+ * Instead, the consumer skips the overwritten elements on its next read. An
+ * element currently accessed through {@link serial_rb_peek} may be overwritten
+ * while it is processed.
+ * <br/>
+ * Since the indices are 16 bit, the consumer could only detect that it was
+ * lapped while the producer is less than 65536 elements ahead of it. If the
+ * consumer does not read for longer, the buffer appears to hold only the
+ * elements written beyond a multiple of 65536 (or to be empty), and the
+ * count of dropped elements is too low.
+ *
+ * @param		*rb			the ringbuffer
+ * @param[in]	policy		one of SERIAL_RB_POLICY_DROP, SERIAL_RB_POLICY_OVERWRITE,
+ * 							SERIAL_RB_POLICY_REJECT
+ */
+void serial_rb_set_policy(serial_rb *rb, unsigned char policy);
+
+/**
+ * Reset the occupancy statistics of a given buffer. The statistics could be
+ * read at any time through the "stats" member of the buffer.
+ * <br/>
+ * Note: on 16-bit targets, the 32-bit counters are not read atomically while
+ * the producer is running.
+ *
+ * @param		*rb			the ringbuffer
+ */
+void serial_rb_stats_clear(serial_rb *rb);
+
 /**
  * Read element from a given buffer. Check if buffer has elements stored 
  * before reading with {@link serial_rb_empty).
+ * <br/>
+ * Must only be called by the consumer.
  *
  * @param		*rb			the ringbuffer to initialize
- * @param[in]	element		the element to add
+ * @return					the element read
  */
 SERIAL_RB_Q serial_rb_read(serial_rb *rb);
 
+/**
+ * Write up to len elements from data to a given buffer. The elements are
+ * copied in at most two contiguous segments (before and after the wrap).
+ * <br/>
+ * Must only be called by the producer.
+ *
+ * @param		*rb			the ringbuffer to write to
+ * @param[in]	*data		the elements to add
+ * @param[in]	len			number of elements to add
+ * @return					number of elements actually written (less than
+ * 							len if the buffer ran out of free elements)
+ */
+unsigned short serial_rb_write_block(serial_rb *rb, const SERIAL_RB_Q *data, unsigned short len);
+
+/**
+ * Read up to len elements from a given buffer into data. The elements are
+ * copied in at most two contiguous segments (before and after the wrap).
+ * <br/>
+ * Must only be called by the consumer.
+ *
+ * @param		*rb			the ringbuffer to read from
+ * @param[out]	*data		where to store the elements read
+ * @param[in]	len			max. number of elements to read
+ * @return					number of elements actually read (less than
+ * 							len if the buffer ran out of elements)
+ */
+unsigned short serial_rb_read_block(serial_rb *rb, SERIAL_RB_Q *data, unsigned short len);
+
+/**
+ * Get the largest contiguous span of free elements in a given buffer. The
+ * span could be filled directly (e.g. by DMA or SPI routines) and then be
+ * made visible to the consumer with {@link serial_rb_commit}.
+ * <br/>
+ * Must only be called by the producer.
+ *
+ * @param		*rb			the ringbuffer to write to
+ * @param[out]	*len		number of elements which could be written to the span
+ * @return					pointer to the first free element
+ */
+SERIAL_RB_Q *serial_rb_reserve(serial_rb *rb, unsigned short *len);
+
+/**
+ * Advance the write index of a given buffer by len elements after they were
+ * written to the span returned by {@link serial_rb_reserve}.
+ * <br/>
+ * Must only be called by the producer.
+ *
+ * @param		*rb			the ringbuffer written to
+ * @param[in]	len			number of elements written (must not exceed the
+ * 							length of the reserved span)
+ */
+void serial_rb_commit(serial_rb *rb, unsigned short len);
+
+/**
+ * Get the largest contiguous span of queued elements in a given buffer. The
+ * span could be processed in place (e.g. by DMA or SPI routines) and then be
+ * released to the producer with {@link serial_rb_consume}.
+ * <br/>
+ * Must only be called by the consumer.
+ *
+ * @param		*rb			the ringbuffer to read from
+ * @param[out]	*len		number of elements which could be read from the span
+ * @return					pointer to the first queued element
+ */
+SERIAL_RB_Q *serial_rb_peek(serial_rb *rb, unsigned short *len);
+
+/**
+ * Advance the read index of a given buffer by len elements after they were
+ * processed from the span returned by {@link serial_rb_peek}.
+ * <br/>
+ * Must only be called by the consumer.
+ *
+ * @param		*rb			the ringbuffer read from
+ * @param[in]	len			number of elements processed (must not exceed the
+ * 							length of the peeked span)
+ */
+void serial_rb_consume(serial_rb *rb, unsigned short len);
+
+/**
+ * Get the next complete line (ended by CR or LF) from a given buffer without
+ * blocking. Delimiters at the start of the buffer (e.g. the LF of a CR/LF) are
+ * skipped. The queued elements are scanned a machine word at a time.
+ * <br/>
+ * The line is returned in place (the delimiter is replaced by '\0') when it
+ * is contiguous in the buffers memory, otherwise it is copied to buf
+ * (truncated to size - 1 characters). In both cases, the line stays valid
+ * until it is released with {@link serial_rb_consume}(rb, *len).
+ * <br/>
+ * If the buffer is full without containing a delimiter, its contents are
+ * discarded, since the line could never be completed.
+ * <br/>
+ * Must only be called by the consumer.
+ *
+ * @param		*rb			the ringbuffer to read from
+ * @param[out]	*buf		buffer for lines wrapping around the end of the
+ * 							ringbuffers memory
+ * @param[in]	size		size of buf (at least 1)
+ * @param[out]	*len		number of elements to consume after the line was
+ * 							processed (line length + delimiter)
+ * @return					the line ('\0' terminated), NULL if there is no
+ * 							complete line yet or size is 0
+ */
+char *serial_rb_readline(serial_rb *rb, char *buf, unsigned short size, unsigned short *len);
+
 #endif // _SERIALRB_H_
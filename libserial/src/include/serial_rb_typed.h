@@ -0,0 +1,125 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SERIALRBTYPED_H_
+#define _SERIALRBTYPED_H_
+
+#include "serial_rb.h"
+
+/**
+ * Generate a ringbuffer type "name" holding "size" elements of "type",
+ * together with a set of inline functions operating on it. The size is
+ * known at compile time and must be a power of two, so masking the indices
+ * folds to a constant AND.
+ * <br/>
+ * Like {@link serial_rb}, the generated ringbuffer is lock-free for
+ * one producer and one consumer.
+ * <br/>
+ * E.g. SERIAL_RB_TYPED(pl_rb, nrf_payload, 4) generates:
+ * <pre>
+ * pl_rb                     the ringbuffer type (contains the buffer memory)
+ * pl_rb_init(rb)            initialize the ringbuffer
+ * pl_rb_used(rb)            number of queued elements
+ * pl_rb_free(rb)            number of free elements
+ * pl_rb_full(rb)            1 if full, 0 otherwise
+ * pl_rb_empty(rb)           1 if empty, 0 otherwise
+ * pl_rb_write(rb, *e)       copy element e into the ringbuffer (producer)
+ * pl_rb_read(rb, *e)        copy oldest element to e (consumer)
+ * pl_rb_back(rb)            pointer to the next free element (producer)
+ * pl_rb_push(rb)            publish element filled through pl_rb_back
+ * pl_rb_front(rb)           pointer to the oldest element (consumer)
+ * pl_rb_pop(rb)             release element accessed through pl_rb_front
+ * </pre>
+ * As for {@link serial_rb}, check full/empty before writing/reading.
+ *
+ * @param	name	name of the generated type (and prefix for its functions)
+ * @param	type	type of the elements
+ * @param	size	number of elements (power of two, max. 32768)
+ */
+#define SERIAL_RB_TYPED(name, type, size)										\
+																				\
+typedef char name##_size_check[(((size) & ((size) - 1)) == 0) ? 1 : -1];		\
+																				\
+typedef struct {																\
+	type buffer[size];															\
+	volatile unsigned short read;												\
+	volatile unsigned short write;												\
+} name;																			\
+																				\
+static inline void name##_init(name *rb)										\
+{																				\
+	rb->read  = 0;																\
+	rb->write = 0;																\
+}																				\
+																				\
+static inline unsigned short name##_used(name *rb)								\
+{																				\
+	return (unsigned short)(rb->write - rb->read);								\
+}																				\
+																				\
+static inline unsigned short name##_free(name *rb)								\
+{																				\
+	return (size) - name##_used(rb);											\
+}																				\
+																				\
+static inline int name##_full(name *rb)											\
+{																				\
+	return (name##_used(rb) == (size));											\
+}																				\
+																				\
+static inline int name##_empty(name *rb)										\
+{																				\
+	return (rb->write == rb->read);												\
+}																				\
+																				\
+static inline type *name##_back(name *rb)										\
+{																				\
+	return &(rb->buffer[rb->write & ((size) - 1)]);								\
+}																				\
+																				\
+static inline void name##_push(name *rb)										\
+{																				\
+	SERIAL_RB_BARRIER();														\
+	rb->write = rb->write + 1;													\
+}																				\
+																				\
+static inline type *name##_front(name *rb)										\
+{																				\
+	return &(rb->buffer[rb->read & ((size) - 1)]);								\
+}																				\
+																				\
+static inline void name##_pop(name *rb)											\
+{																				\
+	SERIAL_RB_BARRIER();														\
+	rb->read = rb->read + 1;													\
+}																				\
+																				\
+static inline void name##_write(name *rb, const type *element)					\
+{																				\
+	*name##_back(rb) = *element;												\
+	name##_push(rb);															\
+}																				\
+																				\
+static inline void name##_read(name *rb, type *element)							\
+{																				\
+	*element = *name##_front(rb);												\
+	name##_pop(rb);																\
+}
+
+#endif // _SERIALRBTYPED_H_
@@ -0,0 +1,51 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERIAL_TIME_H_
+#define __SERIAL_TIME_H_
+
+/**
+ * Start the millisecond time base used for timeouts. On the STM32, SysTick
+ * is used (clocked by HCLK/8), on the MSP430 Timer1_A (clocked by SMCLK/8).
+ * After this, libserial owns the ISR of the timer.
+ *
+ * @param[in]	clkspeed	HCLK (STM32) or SMCLK (MSP430) in Hz
+ */
+void serial_time_init(unsigned long clkspeed);
+
+/**
+ * Milliseconds since {@link serial_time_init} was called. The counter
+ * wraps around after about 49 days, thus always compare differences:
+ * <pre>
+ * if(serial_time_ms() - start >= timeout) ...
+ * </pre>
+ *
+ * @return	milliseconds passed
+ */
+unsigned long serial_time_ms();
+
+/**
+ * Sleep until the next tick of the time base, or until an interrupt which
+ * leaves the low power mode (on the MSP430 the USCI interrupts of
+ * {@link serial_irq_init} leave LPM0, on the STM32 any interrupt ends the
+ * WFI). Thus, this returns after one millisecond at the latest.
+ */
+void serial_time_wait();
+
+#endif
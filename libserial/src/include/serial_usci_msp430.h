@@ -0,0 +1,95 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SERIALUSCIMSP430_H_
+#define _SERIALUSCIMSP430_H_
+
+/**
+ * UCOS16 bit in UCAxMCTL (oversampling mode).
+ */
+#define SERIAL_USCI_OS16		0x01
+
+/**
+ * Max. error (in 1/100 percent) accepted for oversampling mode. If rounding
+ * the divisor to full clock cycles gives a larger error, low-frequency mode
+ * with its 1/8 clock cycle resolution is used instead.
+ */
+#define SERIAL_USCI_OS16_MAX_ERR	50
+
+/**
+ * Error returned by {@link serial_usci_baud} if the baudrate could not be
+ * generated from the clock at all (baudrate 0 or above the clock).
+ */
+#define SERIAL_USCI_ERR_RANGE		0x7FFF
+
+/**
+ * Set while the main loop sleeps in LPM0 waiting for the serial port
+ * ({@link serial_port_recv_sleep}, {@link serial_port_send_sleep}) or for
+ * the time base ({@link serial_time_wait}). Tells the USCI and timer ISRs
+ * to leave LPM0 on exit (library internal).
+ */
+extern volatile unsigned char serial_usci_sleeping;
+
+/**
+ * Calculate the USCI baudrate divisor and modulation for a given clock and
+ * baudrate (see "USCI Baud Rate Generation" in the MSP430x2xx user's guide).
+ * Oversampling mode (UCOS16) is used when the clock is at least 16 times the
+ * baudrate and the resulting error is not above SERIAL_USCI_OS16_MAX_ERR,
+ * otherwise low-frequency mode is used. If the baudrate is 0 or above the
+ * clock, the fastest divisor is set up and SERIAL_USCI_ERR_RANGE is returned.
+ *
+ * @param[in]	clkspeed	clock of the USCI (BRCLK) in Hz
+ * @param[in]	baudrate	desired baudrate
+ * @param[out]	*br			divisor (UCAxBR0 = low byte, UCAxBR1 = high byte)
+ * @param[out]	*mctl		modulation (UCAxMCTL)
+ * @return					error of the resulting baudrate in 1/100 percent
+ */
+static inline __attribute__((always_inline)) int serial_usci_baud(unsigned long clkspeed,
+		unsigned long baudrate, unsigned int *br, unsigned char *mctl)
+{
+	unsigned long n1;
+	unsigned long n8;
+	long err;
+
+	/* The divisor would be 0 (and so the reference for the error). */
+	if(baudrate == 0 || clkspeed < baudrate) {
+		*br   = 1;
+		*mctl = 0;
+		return SERIAL_USCI_ERR_RANGE;
+	}
+
+	/* divisor rounded to full clock cycles and to 1/8 clock cycles */
+	n1 = (clkspeed + baudrate / 2) / baudrate;
+	n8 = (clkspeed * 8 + baudrate / 2) / baudrate;
+
+	err = ((long)(clkspeed - n1 * baudrate) * 100L) / (long)(n1 * baudrate / 100);
+
+	if(n1 >= 16 && err <= SERIAL_USCI_OS16_MAX_ERR && err >= -SERIAL_USCI_OS16_MAX_ERR) {
+		*br   = n1 >> 4;
+		*mctl = ((n1 & 15) << 4) | SERIAL_USCI_OS16;
+		return err;
+	}
+
+	*br   = n8 >> 3;
+	*mctl = (n8 & 7) << 1;
+
+	return ((long)(clkspeed * 8 - n8 * baudrate) * 100L) / (long)(n8 * baudrate / 100);
+}
+
+#endif // _SERIALUSCIMSP430_H_
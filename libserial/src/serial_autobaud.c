@@ -0,0 +1,97 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "serial_autobaud.h"
+
+/**
+ * Standard baudrates detected baudrates are rounded to
+ */
+static const unsigned long serial_autobaud_rates[] = {
+	1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600
+};
+
+unsigned long serial_autobaud_rate(unsigned long clk, unsigned long ticks)
+{
+	unsigned long baud = (clk * 8 + ticks / 2) / ticks;
+	unsigned long diff;
+	unsigned char i;
+
+	for(i = 0; i < sizeof(serial_autobaud_rates) / sizeof(serial_autobaud_rates[0]); i++) {
+		diff = (baud > serial_autobaud_rates[i] ? baud - serial_autobaud_rates[i] :
+			   serial_autobaud_rates[i] - baud);
+
+		if(diff * 20 <= serial_autobaud_rates[i]) {
+			return serial_autobaud_rates[i];
+		}
+	}
+
+	return baud;
+}
+
+unsigned long serial_autobaud_measure(unsigned short (*edge)(void))
+{
+	unsigned short d[4];
+	unsigned short last;
+	unsigned short now;
+	unsigned long  sum;
+	unsigned char  i;
+
+	/*
+	 * Falling edges of the sync character are two bit times apart,
+	 * differences of the 16 bit captures survive a timer overflow.
+	 */
+	last = edge();
+	sum  = 0;
+
+	for(i = 0; i < 4; i++) {
+		now  = edge();
+		d[i] = now - last;
+		last = now;
+		sum += d[i];
+	}
+
+	while(1) {
+		/* All periods must match (within 1/8), otherwise it was no sync (or a glitch). */
+		for(i = 0; i < 4; i++) {
+			if((unsigned long)d[i] * 4 > sum + sum / 8 || (unsigned long)d[i] * 4 < sum - sum / 8) {
+				break;
+			}
+		}
+
+		if(i == 4 && sum >= 16) {
+			return sum;
+		}
+
+		/*
+		 * Slide the window by one edge: drop the oldest period and add the
+		 * next one. Thus, the window finally lines up with the edges of one
+		 * character, even if idle gaps are between the characters.
+		 */
+		sum -= d[0];
+
+		for(i = 0; i < 3; i++) {
+			d[i] = d[i + 1];
+		}
+
+		now  = edge();
+		d[3] = now - last;
+		last = now;
+		sum += d[3];
+	}
+}
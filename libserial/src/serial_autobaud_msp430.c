@@ -0,0 +1,67 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <msp430.h>
+#include <legacymsp430.h>
+
+#include "serial.h"
+#include "serial_autobaud.h"
+
+/**
+ * RXD pin (TA0.CCI0A)
+ */
+#define UART_RXD   		BIT1
+
+/**
+ * Wait for the next falling edge on RXD and return its capture time.
+ */
+static unsigned short serial_autobaud_edge(void)
+{
+	while(!(TA0CCTL0 & CCIFG));
+
+	TA0CCTL0 &= ~CCIFG;
+
+	return TA0CCR0;
+}
+
+unsigned long serial_autobaud_init(long clkspeed)
+{
+	unsigned long sum;
+	unsigned long baud;
+
+	/* RXD to the capture input of Timer0_A. */
+	P1DIR    &= ~UART_RXD;
+	P1SEL    |=  UART_RXD;
+	P1SEL2   &= ~UART_RXD;
+
+	/* SMCLK, continuous mode, capture on falling edges. */
+	TA0CCTL0  = CM_2 + CCIS_0 + SCS + CAP;
+	TA0CTL    = TASSEL_2 + MC_2 + TACLR;
+
+	sum = serial_autobaud_measure(serial_autobaud_edge);
+
+	TA0CTL    = MC_0;
+	TA0CCTL0  = 0;
+
+	baud = serial_autobaud_rate(clkspeed, sum);
+
+	serial_clk_init(clkspeed, baud);
+
+	return baud;
+}
@@ -0,0 +1,81 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libopencm3/stm32/f1/rcc.h>
+#include <libopencm3/stm32/f1/gpio.h>
+#include <libopencm3/stm32/timer.h>
+
+#include "serial.h"
+#include "serial_autobaud.h"
+
+/**
+ * Prescaler of TIM1 while measuring (72MHz / 8 still resolves 921600 baud,
+ * and 1200 baud does not overflow the counter between two edges)
+ */
+#define SERIAL_AUTOBAUD_PSC		8
+
+/**
+ * Wait for the next falling edge on RX and return its capture time (reading
+ * CCR3 clears the capture flag).
+ */
+static unsigned short serial_autobaud_edge(void)
+{
+	while(!(TIM_SR(TIM1) & TIM_SR_CC3IF));
+
+	return TIM_CCR3(TIM1);
+}
+
+unsigned long serial_autobaud_init(long clkspeed)
+{
+	unsigned long sum;
+	unsigned long clk;
+	unsigned long baud;
+
+	rcc_peripheral_enable_clock(&RCC_APB2ENR, RCC_APB2ENR_IOPAEN | RCC_APB2ENR_TIM1EN);
+
+	/* USART1 RX (PA10) is also TIM1 channel 3. */
+	gpio_set_mode(GPIOA, GPIO_MODE_INPUT, GPIO_CNF_INPUT_FLOAT, GPIO_USART1_RX);
+
+	TIM_PSC(TIM1)   = SERIAL_AUTOBAUD_PSC - 1;
+	TIM_ARR(TIM1)   = 0xFFFF;
+	TIM_EGR(TIM1)   = TIM_EGR_UG;
+
+	/* Capture TI3 on falling edges. */
+	TIM_CCMR2(TIM1) = TIM_CCMR2_CC3S_IN_TI3;
+	TIM_CCER(TIM1)  = TIM_CCER_CC3P | TIM_CCER_CC3E;
+	TIM_CR1(TIM1)   = TIM_CR1_CEN;
+
+	sum = serial_autobaud_measure(serial_autobaud_edge);
+
+	TIM_CR1(TIM1)   = 0;
+	TIM_CCER(TIM1)  = 0;
+
+	/* Timers on APB2 run at twice PCLK2 if APB2 is divided. */
+	clk = rcc_ppre2_frequency;
+
+	if(RCC_CFGR & (1 << 13)) {
+		clk *= 2;
+	}
+
+	baud = serial_autobaud_rate(clk / SERIAL_AUTOBAUD_PSC, sum);
+
+	serial_clk_init(clkspeed, baud);
+
+	return baud;
+}
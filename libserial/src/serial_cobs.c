@@ -0,0 +1,222 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "serial_cobs.h"
+
+/**
+ * Number of free elements in the ringbuffer, taking the bytes written but
+ * not yet published by the encoder into account.
+ */
+static unsigned short serial_cobs_room(serial_cobs_enc *enc)
+{
+	return enc->rb->elements - (unsigned short)(enc->pos - enc->rb->read);
+}
+
+/**
+ * Write the code byte of the current block and publish the block.
+ */
+static void serial_cobs_close(serial_cobs_enc *enc)
+{
+	serial_rb *rb = enc->rb;
+
+	rb->buffer[enc->code_pos & rb->mask] = enc->code;
+
+	serial_rb_commit(rb, (unsigned short)(enc->pos - rb->write));
+}
+
+/**
+ * Reserve the code byte of a new block.
+ */
+static void serial_cobs_open(serial_cobs_enc *enc)
+{
+	enc->code_pos = enc->pos++;
+	enc->code     = 1;
+}
+
+void serial_cobs_enc_init(serial_cobs_enc *enc, serial_rb *rb)
+{
+	enc->rb       = rb;
+	enc->pos      = rb->write;
+	enc->code_pos = rb->write;
+	enc->code     = 1;
+}
+
+int serial_cobs_enc_begin(serial_cobs_enc *enc)
+{
+	enc->pos = enc->rb->write;
+
+	if(serial_cobs_room(enc) < 1) {
+		return -1;
+	}
+
+	serial_cobs_open(enc);
+
+	return 0;
+}
+
+int serial_cobs_enc_put(serial_cobs_enc *enc, unsigned char data)
+{
+	serial_rb *rb = enc->rb;
+
+	if(data == 0) {
+		/* The zero is replaced by the code byte of the current block. */
+		if(serial_cobs_room(enc) < 1) {
+			return -1;
+		}
+
+		serial_cobs_close(enc);
+		serial_cobs_open(enc);
+
+		return 0;
+	}
+
+	/* A byte which fills the block also needs the code byte of the next. */
+	if(serial_cobs_room(enc) < (enc->code == SERIAL_COBS_BLOCK - 1 ? 2 : 1)) {
+		return -1;
+	}
+
+	rb->buffer[enc->pos++ & rb->mask] = data;
+
+	if(++enc->code == SERIAL_COBS_BLOCK) {
+		serial_cobs_close(enc);
+		serial_cobs_open(enc);
+	}
+
+	return 0;
+}
+
+unsigned short serial_cobs_enc_write(serial_cobs_enc *enc, const unsigned char *data, unsigned short len)
+{
+	unsigned short i;
+
+	for(i = 0; i < len; i++) {
+		if(serial_cobs_enc_put(enc, data[i]) < 0) {
+			break;
+		}
+	}
+
+	return i;
+}
+
+int serial_cobs_enc_end(serial_cobs_enc *enc)
+{
+	serial_rb *rb = enc->rb;
+
+	if(serial_cobs_room(enc) < 1) {
+		return -1;
+	}
+
+	rb->buffer[enc->pos++ & rb->mask] = 0;
+
+	serial_cobs_close(enc);
+
+	return 0;
+}
+
+void serial_cobs_dec_init(serial_cobs_dec *dec, unsigned char *frame, unsigned short size)
+{
+	dec->frame = frame;
+	dec->size  = size;
+	dec->len   = 0;
+	dec->left  = 0;
+	dec->zero  = 0;
+	dec->error = 0;
+}
+
+int serial_cobs_dec_put(serial_cobs_dec *dec, unsigned char data)
+{
+	int ret;
+
+	if(data == 0) {
+		/* End of frame: must not be in the middle of a block. */
+		if(dec->error || dec->left != 0) {
+			ret = -1;
+		}
+		else {
+			ret = dec->len;
+		}
+
+		dec->len   = 0;
+		dec->left  = 0;
+		dec->zero  = 0;
+		dec->error = 0;
+
+		return ret;
+	}
+
+	if(dec->error) {
+		return 0;
+	}
+
+	if(dec->left == 0) {
+		/* Code byte: the zero replaced by the previous block comes first. */
+		if(dec->zero) {
+			if(dec->len == dec->size) {
+				dec->error = 1;
+				return 0;
+			}
+			dec->frame[dec->len++] = 0;
+		}
+
+		dec->left = data - 1;
+		dec->zero = (data != SERIAL_COBS_BLOCK);
+
+		return 0;
+	}
+
+	if(dec->len == dec->size) {
+		dec->error = 1;
+		return 0;
+	}
+
+	dec->frame[dec->len++] = data;
+	dec->left--;
+
+	return 0;
+}
+
+int serial_cobs_dec_rb(serial_cobs_dec *dec, serial_rb *rb)
+{
+	SERIAL_RB_Q *span;
+	unsigned short len;
+	unsigned short i;
+	int ret;
+
+	/* The queued bytes may wrap around the end of the buffer memory. */
+	while(1) {
+		span = serial_rb_peek(rb, &len);
+
+		if(len == 0) {
+			break;
+		}
+
+		for(i = 0; i < len; i++) {
+			ret = serial_cobs_dec_put(dec, span[i]);
+
+			if(ret != 0) {
+				serial_rb_consume(rb, i + 1);
+				return ret;
+			}
+		}
+
+		serial_rb_consume(rb, len);
+	}
+
+	return 0;
+}
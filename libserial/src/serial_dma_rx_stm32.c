@@ -0,0 +1,128 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libopencm3/stm32/f1/rcc.h>
+#include <libopencm3/stm32/f1/nvic.h>
+#include <libopencm3/stm32/f1/dma.h>
+#include <libopencm3/stm32/usart.h>
+
+#include "serial_dma.h"
+#include "serial_usart_stm32.h"
+
+/**
+ * DMA channel connected to USART1_RX
+ */
+#define SERIAL_DMA_RX_CH	DMA_CHANNEL5
+
+/**
+ * Ringbuffer the DMA writes to
+ */
+static serial_rb *serial_dma_rx_rb;
+
+/**
+ * Position within the ringbuffer memory the DMA was at during the last update
+ */
+static unsigned short serial_dma_rx_pos;
+
+/**
+ * Publish the bytes the DMA wrote since the last update to the ringbuffer.
+ * Called from the DMA (half/full transfer) ISR and, on idle line, from the
+ * shared USART ISR through {@link serial_irq_idle_hook},
+ * thus at most half of the buffer is written between two updates.
+ */
+static void serial_dma_rx_update(void)
+{
+	unsigned short pos;
+	unsigned short len;
+	unsigned short free;
+
+	pos = serial_dma_rx_rb->elements - DMA_CNDTR(DMA1, SERIAL_DMA_RX_CH);
+
+	if(pos == serial_dma_rx_rb->elements) {
+		pos = 0;
+	}
+
+	len  = (pos - serial_dma_rx_pos) & serial_dma_rx_rb->mask;
+	free = serial_rb_free(serial_dma_rx_rb);
+
+	/* DMA already overwrote the oldest bytes, consumer skips them. */
+	if(len > free) {
+		serial_dma_rx_rb->stats.dropped += len - free;
+	}
+
+	serial_dma_rx_pos = pos;
+
+	serial_rb_commit(serial_dma_rx_rb, len);
+}
+
+void serial_dma_rx_init(serial_rb *rb)
+{
+	serial_dma_rx_rb  = rb;
+	serial_dma_rx_pos = 0;
+
+	/* DMA starts at the beginning of the buffer memory. */
+	rb->read  = 0;
+	rb->write = 0;
+
+	/* DMA never stops, thus received bytes overwrite the oldest ones. */
+	serial_rb_set_policy(rb, SERIAL_RB_POLICY_OVERWRITE);
+
+	/* Enable clock for DMA1. */
+	rcc_peripheral_enable_clock(&RCC_AHBENR, RCC_AHBENR_DMA1EN);
+
+	dma_channel_reset(DMA1, SERIAL_DMA_RX_CH);
+
+	dma_set_peripheral_address(DMA1, SERIAL_DMA_RX_CH, (unsigned long)&USART1_DR);
+	dma_set_memory_address(DMA1, SERIAL_DMA_RX_CH, (unsigned long)rb->buffer);
+	dma_set_number_of_data(DMA1, SERIAL_DMA_RX_CH, rb->elements);
+	dma_set_read_from_peripheral(DMA1, SERIAL_DMA_RX_CH);
+	dma_enable_memory_increment_mode(DMA1, SERIAL_DMA_RX_CH);
+	dma_enable_circular_mode(DMA1, SERIAL_DMA_RX_CH);
+	dma_set_peripheral_size(DMA1, SERIAL_DMA_RX_CH, DMA_CCR_PSIZE_8BIT);
+	dma_set_memory_size(DMA1, SERIAL_DMA_RX_CH, DMA_CCR_MSIZE_8BIT);
+	dma_set_priority(DMA1, SERIAL_DMA_RX_CH, DMA_CCR_PL_VERY_HIGH);
+	dma_enable_half_transfer_interrupt(DMA1, SERIAL_DMA_RX_CH);
+	dma_enable_transfer_complete_interrupt(DMA1, SERIAL_DMA_RX_CH);
+
+	/* The shared USART1 ISR publishes the received bytes on idle line. */
+	serial_irq_idle_hook[SERIAL_PORT1] = serial_dma_rx_update;
+
+	/* Enable the DMA1 channel 5 and USART1 interrupts. */
+	nvic_enable_irq(NVIC_DMA1_CHANNEL5_IRQ);
+	nvic_enable_irq(NVIC_USART1_IRQ);
+
+	dma_enable_channel(DMA1, SERIAL_DMA_RX_CH);
+
+	/* Let USART1 hand received data to the DMA, interrupt on idle line. */
+	usart_enable_rx_dma(USART1);
+	USART_CR1(USART1) |= USART_CR1_IDLEIE;
+}
+
+void dma1_channel5_isr(void)
+{
+	if((DMA_ISR(DMA1) & DMA_ISR_HTIF5) != 0) {
+		DMA_IFCR(DMA1) |= DMA_IFCR_CHTIF5;
+	}
+
+	if((DMA_ISR(DMA1) & DMA_ISR_TCIF5) != 0) {
+		DMA_IFCR(DMA1) |= DMA_IFCR_CTCIF5;
+	}
+
+	serial_dma_rx_update();
+}
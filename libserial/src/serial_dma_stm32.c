@@ -0,0 +1,151 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libopencm3/stm32/f1/rcc.h>
+#include <libopencm3/stm32/f1/nvic.h>
+#include <libopencm3/stm32/f1/dma.h>
+#include <libopencm3/stm32/usart.h>
+
+#include "serial_dma.h"
+
+/**
+ * DMA channel connected to USART1_TX
+ */
+#define SERIAL_DMA_TX_CH	DMA_CHANNEL4
+
+/**
+ * Number of bytes in the current transfer (0 if idle)
+ */
+static volatile unsigned short serial_dma_tx_len;
+
+/**
+ * Ringbuffer drained by DMA (NULL if sending from a plain buffer)
+ */
+static serial_rb *volatile serial_dma_tx_rb;
+
+static void (*serial_dma_tx_done)(void);
+
+static void serial_dma_tx_start(const unsigned char *data, unsigned short len)
+{
+	serial_dma_tx_len = len;
+
+	dma_channel_reset(DMA1, SERIAL_DMA_TX_CH);
+
+	dma_set_peripheral_address(DMA1, SERIAL_DMA_TX_CH, (unsigned long)&USART1_DR);
+	dma_set_memory_address(DMA1, SERIAL_DMA_TX_CH, (unsigned long)data);
+	dma_set_number_of_data(DMA1, SERIAL_DMA_TX_CH, len);
+	dma_set_read_from_memory(DMA1, SERIAL_DMA_TX_CH);
+	dma_enable_memory_increment_mode(DMA1, SERIAL_DMA_TX_CH);
+	dma_set_peripheral_size(DMA1, SERIAL_DMA_TX_CH, DMA_CCR_PSIZE_8BIT);
+	dma_set_memory_size(DMA1, SERIAL_DMA_TX_CH, DMA_CCR_MSIZE_8BIT);
+	dma_set_priority(DMA1, SERIAL_DMA_TX_CH, DMA_CCR_PL_HIGH);
+	dma_enable_transfer_complete_interrupt(DMA1, SERIAL_DMA_TX_CH);
+
+	dma_enable_channel(DMA1, SERIAL_DMA_TX_CH);
+}
+
+static int serial_dma_tx_next_span(void)
+{
+	unsigned short len;
+	unsigned char *span = serial_rb_peek(serial_dma_tx_rb, &len);
+
+	if(len == 0) {
+		return 0;
+	}
+
+	serial_dma_tx_start(span, len);
+
+	return 1;
+}
+
+void serial_dma_init(void)
+{
+	/* Enable clock for DMA1. */
+	rcc_peripheral_enable_clock(&RCC_AHBENR, RCC_AHBENR_DMA1EN);
+
+	/* Enable the DMA1 channel 4 interrupt. */
+	nvic_enable_irq(NVIC_DMA1_CHANNEL4_IRQ);
+
+	/* Let USART1 request data from the DMA. */
+	usart_enable_tx_dma(USART1);
+
+	serial_dma_tx_len = 0;
+	serial_dma_tx_rb  = 0;
+}
+
+void serial_dma_set_callback(void (*done)(void))
+{
+	serial_dma_tx_done = done;
+}
+
+int serial_dma_busy(void)
+{
+	return (serial_dma_tx_len != 0);
+}
+
+int serial_dma_send(const unsigned char *data, unsigned short len)
+{
+	if(serial_dma_busy()) {
+		return -1;
+	}
+
+	if(len > 0) {
+		serial_dma_tx_rb = 0;
+		serial_dma_tx_start(data, len);
+	}
+
+	return 0;
+}
+
+int serial_dma_send_rb(serial_rb *rb)
+{
+	if(serial_dma_busy()) {
+		/* DMA ISR picks up new data by itself when draining this rb. */
+		return (serial_dma_tx_rb == rb ? 0 : -1);
+	}
+
+	serial_dma_tx_rb = rb;
+	serial_dma_tx_next_span();
+
+	return 0;
+}
+
+void dma1_channel4_isr(void)
+{
+	if((DMA_ISR(DMA1) & DMA_ISR_TCIF4) != 0) {
+		DMA_IFCR(DMA1) |= DMA_IFCR_CTCIF4;
+
+		dma_disable_channel(DMA1, SERIAL_DMA_TX_CH);
+
+		if(serial_dma_tx_rb) {
+			serial_rb_consume(serial_dma_tx_rb, serial_dma_tx_len);
+
+			/* Continue with data added (or wrapped) in the meantime. */
+			if(serial_dma_tx_next_span()) {
+				return;
+			}
+		}
+
+		serial_dma_tx_len = 0;
+
+		if(serial_dma_tx_done) {
+			serial_dma_tx_done();
+		}
+	}
+}
@@ -0,0 +1,258 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "serial.h"
+#include "serial_irq.h"
+#include "serial_pty_host.h"
+
+/*
+ * On the host, the ISRs are emulated by one thread per port. The thread is
+ * the producer of the RX ringbuffer and the consumer of the TX ringbuffer,
+ * thus the lock-free ringbuffers work the same way as on the MCUs.
+ */
+
+static serial_rb *serial_irq_rx[SERIAL_PORTS];
+
+static serial_rb *serial_irq_tx[SERIAL_PORTS];
+
+static serial_flow serial_irq_flow[SERIAL_PORTS];
+
+/**
+ * Pipe used to wake up the thread of each port
+ */
+static int serial_irq_wake[SERIAL_PORTS][2];
+
+/**
+ * Used to wait for the thread of each port (replaces sleeping until the
+ * next interrupt)
+ */
+static pthread_mutex_t serial_irq_lock[SERIAL_PORTS] = {
+	PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER
+};
+
+static pthread_cond_t serial_irq_cond[SERIAL_PORTS] = {
+	PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER
+};
+
+static void serial_irq_signal(serial_port port)
+{
+	pthread_mutex_lock(&serial_irq_lock[port]);
+	pthread_cond_broadcast(&serial_irq_cond[port]);
+	pthread_mutex_unlock(&serial_irq_lock[port]);
+}
+
+static void serial_irq_kick(serial_port port)
+{
+	unsigned char c = 0;
+
+	if(write(serial_irq_wake[port][1], &c, 1) != 1) {
+		/* pipe is full, thread is woken up anyway */
+	}
+}
+
+static void *serial_irq_thread(void *arg)
+{
+	serial_port port = (serial_port)(unsigned long)arg;
+	serial_rb *rx    = serial_irq_rx[port];
+	serial_rb *tx    = serial_irq_tx[port];
+	struct pollfd pfd[2];
+	unsigned char *span;
+	unsigned short len;
+	unsigned char drain[16];
+	ssize_t n;
+
+	pfd[0].fd = serial_pty_fds[port];
+	pfd[1].fd = serial_irq_wake[port][0];
+	pfd[1].events = POLLIN;
+
+	while(1) {
+		/*
+		 * Only read while there is room in the RX ringbuffer, the pty then
+		 * applies backpressure to the peer (no bytes get lost).
+		 */
+		pfd[0].events = 0;
+
+		if(rx && !serial_rb_full(rx)) {
+			pfd[0].events |= POLLIN;
+		}
+		if(tx && !serial_rb_empty(tx)) {
+			pfd[0].events |= POLLOUT;
+		}
+
+		if(poll(pfd, 2, -1) < 0) {
+			continue;
+		}
+
+		if(pfd[1].revents & POLLIN) {
+			n = read(pfd[1].fd, drain, sizeof(drain));
+		}
+
+		if(pfd[0].revents & POLLIN) {
+			span = serial_rb_reserve(rx, &len);
+			n = read(pfd[0].fd, span, len);
+
+			if(n > 0) {
+				serial_rb_commit(rx, (unsigned short)n);
+				serial_irq_signal(port);
+			}
+		}
+
+		if(pfd[0].revents & POLLOUT) {
+			span = serial_rb_peek(tx, &len);
+			n = write(pfd[0].fd, span, len);
+
+			if(n > 0) {
+				serial_rb_consume(tx, (unsigned short)n);
+				serial_irq_signal(port);
+			}
+		}
+	}
+
+	return 0;
+}
+
+void serial_irq_init(serial_rb *rx, serial_rb *tx)
+{
+	serial_port_irq_init(SERIAL_PORT1, rx, tx);
+}
+
+unsigned short serial_write(const unsigned char *data, unsigned short len)
+{
+	return serial_port_write(SERIAL_PORT1, data, len);
+}
+
+unsigned short serial_read(unsigned char *data, unsigned short len)
+{
+	return serial_port_read(SERIAL_PORT1, data, len);
+}
+
+unsigned char serial_recv_sleep()
+{
+	return serial_port_recv_sleep(SERIAL_PORT1);
+}
+
+void serial_send_sleep(unsigned char data)
+{
+	serial_port_send_sleep(SERIAL_PORT1, data);
+}
+
+void serial_port_irq_init(serial_port port, serial_rb *rx, serial_rb *tx)
+{
+	pthread_t thread;
+
+	serial_irq_rx[port] = rx;
+	serial_irq_tx[port] = tx;
+
+	/* The thread must never block in read/write, only in poll. */
+	fcntl(serial_pty_fds[port], F_SETFL, fcntl(serial_pty_fds[port], F_GETFL) | O_NONBLOCK);
+
+	if(pipe2(serial_irq_wake[port], O_NONBLOCK) < 0 ||
+	   pthread_create(&thread, 0, serial_irq_thread, (void *)(unsigned long)port) != 0) {
+		perror("libserial: serial_port_irq_init");
+		exit(1);
+	}
+
+	pthread_detach(thread);
+}
+
+unsigned short serial_port_write(serial_port port, const unsigned char *data, unsigned short len)
+{
+	len = serial_rb_write_block(serial_irq_tx[port], data, len);
+
+	if(len > 0) {
+		serial_irq_kick(port);
+	}
+
+	return len;
+}
+
+unsigned short serial_port_read(serial_port port, unsigned char *data, unsigned short len)
+{
+	len = serial_rb_read_block(serial_irq_rx[port], data, len);
+
+	/*
+	 * The thread may have found the ringbuffer full (and stopped reading from
+	 * the pty) at any time before this read, thus always tell it there is room
+	 * again. A kick pending in the pipe makes it re-check before polling.
+	 */
+	if(len > 0) {
+		serial_irq_kick(port);
+	}
+
+	return len;
+}
+
+unsigned char serial_port_recv_sleep(serial_port port)
+{
+	unsigned char data;
+
+	pthread_mutex_lock(&serial_irq_lock[port]);
+
+	while(serial_rb_empty(serial_irq_rx[port])) {
+		pthread_cond_wait(&serial_irq_cond[port], &serial_irq_lock[port]);
+	}
+
+	pthread_mutex_unlock(&serial_irq_lock[port]);
+
+	serial_port_read(port, &data, 1);
+
+	return data;
+}
+
+void serial_port_send_sleep(serial_port port, unsigned char data)
+{
+	pthread_mutex_lock(&serial_irq_lock[port]);
+
+	while(serial_rb_full(serial_irq_tx[port])) {
+		pthread_cond_wait(&serial_irq_cond[port], &serial_irq_lock[port]);
+	}
+
+	pthread_mutex_unlock(&serial_irq_lock[port]);
+
+	serial_port_write(port, &data, 1);
+}
+
+void serial_flow_init(unsigned short hwm, unsigned short lwm)
+{
+	serial_port_flow_init(SERIAL_PORT1, hwm, lwm);
+}
+
+void serial_port_flow_init(serial_port port, unsigned short hwm, unsigned short lwm)
+{
+	/* The pty always applies backpressure, nothing to drive. */
+	serial_irq_flow[port].hwm     = hwm;
+	serial_irq_flow[port].lwm     = lwm;
+	serial_irq_flow[port].stopped = 0;
+}
+
+void serial_port_flow_update(serial_port port)
+{
+	if(serial_irq_rx[port] && serial_rb_full(serial_irq_rx[port]) == 0) {
+		serial_irq_kick(port);
+	}
+}
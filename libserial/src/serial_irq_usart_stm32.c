@@ -0,0 +1,227 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libopencm3/stm32/f1/nvic.h>
+#include <libopencm3/stm32/f1/gpio.h>
+#include <libopencm3/stm32/usart.h>
+
+#include "serial.h"
+#include "serial_irq.h"
+#include "serial_usart_stm32.h"
+
+static serial_rb *serial_irq_rx[SERIAL_PORTS];
+
+static serial_rb *serial_irq_tx[SERIAL_PORTS];
+
+static serial_flow serial_irq_flow[SERIAL_PORTS];
+
+void (*serial_irq_idle_hook[SERIAL_PORTS])(void);
+
+/*
+ * While waiting, interrupts are masked (PRIMASK) around the check of the
+ * ringbuffer. WFI still wakes up on a pending interrupt, which then is
+ * handled as soon as the mask is cleared, thus no wakeup is missed.
+ */
+#define SERIAL_IRQ_SLEEP_WHILE(cond)							\
+	do {														\
+		__asm__ volatile ("cpsid i" ::: "memory");				\
+		while(cond) {											\
+			__asm__ volatile ("wfi");							\
+			__asm__ volatile ("cpsie i" ::: "memory");			\
+			__asm__ volatile ("cpsid i" ::: "memory");			\
+		}														\
+		__asm__ volatile ("cpsie i" ::: "memory");				\
+	} while(0)
+
+void serial_irq_init(serial_rb *rx, serial_rb *tx)
+{
+	serial_port_irq_init(SERIAL_PORT1, rx, tx);
+}
+
+unsigned short serial_write(const unsigned char *data, unsigned short len)
+{
+	return serial_port_write(SERIAL_PORT1, data, len);
+}
+
+unsigned short serial_read(unsigned char *data, unsigned short len)
+{
+	return serial_port_read(SERIAL_PORT1, data, len);
+}
+
+unsigned char serial_recv_sleep()
+{
+	return serial_port_recv_sleep(SERIAL_PORT1);
+}
+
+void serial_send_sleep(unsigned char data)
+{
+	serial_port_send_sleep(SERIAL_PORT1, data);
+}
+
+void serial_port_irq_init(serial_port port, serial_rb *rx, serial_rb *tx)
+{
+	const serial_usart_port *p = &serial_usart_ports[port];
+
+	serial_irq_rx[port] = rx;
+	serial_irq_tx[port] = tx;
+
+	/* Enable the USART interrupt. */
+	nvic_enable_irq(p->irq);
+
+	/* Enable Receive interrupt (TX interrupt is enabled on demand). */
+	if(rx) {
+		USART_CR1(p->usart) |= USART_CR1_RXNEIE;
+	}
+}
+
+unsigned short serial_port_write(serial_port port, const unsigned char *data, unsigned short len)
+{
+	len = serial_rb_write_block(serial_irq_tx[port], data, len);
+
+	/* Let the TXE interrupt drain the ringbuffer. */
+	if(len > 0) {
+		USART_CR1(serial_usart_ports[port].usart) |= USART_CR1_TXEIE;
+	}
+
+	return len;
+}
+
+unsigned short serial_port_read(serial_port port, unsigned char *data, unsigned short len)
+{
+	len = serial_rb_read_block(serial_irq_rx[port], data, len);
+
+	serial_port_flow_update(port);
+
+	return len;
+}
+
+unsigned char serial_port_recv_sleep(serial_port port)
+{
+	unsigned char data;
+
+	SERIAL_IRQ_SLEEP_WHILE(serial_rb_empty(serial_irq_rx[port]));
+
+	serial_port_read(port, &data, 1);
+
+	return data;
+}
+
+void serial_port_send_sleep(serial_port port, unsigned char data)
+{
+	SERIAL_IRQ_SLEEP_WHILE(serial_rb_full(serial_irq_tx[port]));
+
+	serial_port_write(port, &data, 1);
+}
+
+void serial_flow_init(unsigned short hwm, unsigned short lwm)
+{
+	serial_port_flow_init(SERIAL_PORT1, hwm, lwm);
+}
+
+void serial_port_flow_init(serial_port port, unsigned short hwm, unsigned short lwm)
+{
+	const serial_usart_port *p = &serial_usart_ports[port];
+
+	serial_irq_flow[port].hwm     = hwm;
+	serial_irq_flow[port].lwm     = lwm;
+	serial_irq_flow[port].stopped = 0;
+
+	/* RTS is driven by software from the RX ringbuffer level (low = ready). */
+	gpio_clear(p->gpio, p->rts);
+	gpio_set_mode(p->gpio, GPIO_MODE_OUTPUT_50_MHZ, GPIO_CNF_OUTPUT_PUSHPULL, p->rts);
+
+	/* CTS is handled by the USART, it stops sending while CTS is high. */
+	gpio_set_mode(p->gpio, GPIO_MODE_INPUT, GPIO_CNF_INPUT_FLOAT, p->cts);
+	USART_CR3(p->usart) |= USART_CR3_CTSE;
+}
+
+void serial_port_flow_update(serial_port port)
+{
+	serial_flow *f = &serial_irq_flow[port];
+
+	if(f->stopped && serial_rb_used(serial_irq_rx[port]) <= f->lwm) {
+		f->stopped = 0;
+		gpio_clear(serial_usart_ports[port].gpio, serial_usart_ports[port].rts);
+	}
+}
+
+static void serial_irq_handler(serial_port port)
+{
+	unsigned long usart = serial_usart_ports[port].usart;
+	unsigned char c;
+
+	/*
+	 * Check if we were called because of RXNE (reading DR also clears ORE).
+	 * Without RX interrupt (TX only), received bytes are left to the caller.
+	 */
+	if(((USART_CR1(usart) & USART_CR1_RXNEIE) != 0) &&
+	   ((USART_SR(usart) & USART_SR_RXNE) != 0)) {
+		c = usart_recv(usart);
+
+		if(serial_irq_rx[port]) {
+			serial_rb_put(serial_irq_rx[port], c);
+
+			/* Ask the sender to pause when crossing the high watermark. */
+			if(serial_irq_flow[port].hwm != 0 && !serial_irq_flow[port].stopped &&
+			   serial_rb_used(serial_irq_rx[port]) >= serial_irq_flow[port].hwm) {
+				serial_irq_flow[port].stopped = 1;
+				gpio_set(serial_usart_ports[port].gpio, serial_usart_ports[port].rts);
+			}
+		}
+	}
+
+	/* Check if we were called because of an idle line. */
+	if(((USART_CR1(usart) & USART_CR1_IDLEIE) != 0) &&
+	   ((USART_SR(usart) & USART_SR_IDLE) != 0)) {
+		/* Reading SR followed by DR clears the IDLE flag. */
+		(void)USART_DR(usart);
+
+		if(serial_irq_idle_hook[port]) {
+			serial_irq_idle_hook[port]();
+		}
+	}
+
+	/* Check if we were called because of TXE. */
+	if(((USART_CR1(usart) & USART_CR1_TXEIE) != 0) &&
+	   ((USART_SR(usart) & USART_SR_TXE) != 0)) {
+
+		if(!serial_rb_empty(serial_irq_tx[port])) {
+			usart_send(usart, serial_rb_read(serial_irq_tx[port]));
+		}
+		else {
+			/* Disable the TXE interrupt, it's no longer needed. */
+			USART_CR1(usart) &= ~USART_CR1_TXEIE;
+		}
+	}
+}
+
+void usart1_isr(void)
+{
+	serial_irq_handler(SERIAL_PORT1);
+}
+
+void usart2_isr(void)
+{
+	serial_irq_handler(SERIAL_PORT2);
+}
+
+void usart3_isr(void)
+{
+	serial_irq_handler(SERIAL_PORT3);
+}
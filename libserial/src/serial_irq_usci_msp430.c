@@ -0,0 +1,209 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <msp430.h>
+#include <legacymsp430.h>
+
+#include "serial.h"
+#include "serial_irq.h"
+#include "serial_usci_msp430.h"
+
+/**
+ * RTS pin (on P2) used for flow control
+ */
+#ifndef SERIAL_RTS
+#define SERIAL_RTS		BIT0
+#endif
+
+static serial_rb *serial_irq_rx;
+
+static serial_rb *serial_irq_tx;
+
+static serial_flow serial_irq_flow;
+
+void serial_irq_init(serial_rb *rx, serial_rb *tx)
+{
+	serial_port_irq_init(SERIAL_PORT1, rx, tx);
+}
+
+unsigned short serial_write(const unsigned char *data, unsigned short len)
+{
+	return serial_port_write(SERIAL_PORT1, data, len);
+}
+
+unsigned short serial_read(unsigned char *data, unsigned short len)
+{
+	return serial_port_read(SERIAL_PORT1, data, len);
+}
+
+unsigned char serial_recv_sleep()
+{
+	return serial_port_recv_sleep(SERIAL_PORT1);
+}
+
+void serial_send_sleep(unsigned char data)
+{
+	serial_port_send_sleep(SERIAL_PORT1, data);
+}
+
+/*
+ * The MSP430G2553 only has USCI_A0 as UART, thus the port handle is
+ * ignored by the serial_port_* functions.
+ */
+
+void serial_port_irq_init(serial_port port, serial_rb *rx, serial_rb *tx)
+{
+	(void)port;
+
+	serial_irq_rx = rx;
+	serial_irq_tx = tx;
+
+	/* RX interrupt is enabled right away, TX interrupt on demand. */
+	if(rx) {
+		IE2 |= UCA0RXIE;
+	}
+
+	__bis_SR_register(GIE);
+}
+
+unsigned short serial_port_write(serial_port port, const unsigned char *data, unsigned short len)
+{
+	(void)port;
+
+	len = serial_rb_write_block(serial_irq_tx, data, len);
+
+	/* Let the TX interrupt drain the ringbuffer. */
+	if(len > 0) {
+		IE2 |= UCA0TXIE;
+	}
+
+	return len;
+}
+
+unsigned short serial_port_read(serial_port port, unsigned char *data, unsigned short len)
+{
+	len = serial_rb_read_block(serial_irq_rx, data, len);
+
+	serial_port_flow_update(port);
+
+	return len;
+}
+
+unsigned char serial_port_recv_sleep(serial_port port)
+{
+	unsigned char data;
+
+	/*
+	 * Interrupts are disabled while checking the ringbuffer. Entering LPM0
+	 * sets GIE in the same instruction, thus a byte received right after the
+	 * check still wakes us up.
+	 */
+	__dint();
+	serial_usci_sleeping = 1;
+
+	while(serial_rb_empty(serial_irq_rx)) {
+		__bis_SR_register(LPM0_bits + GIE);
+		__dint();
+	}
+
+	serial_usci_sleeping = 0;
+	__eint();
+
+	serial_port_read(port, &data, 1);
+
+	return data;
+}
+
+void serial_port_send_sleep(serial_port port, unsigned char data)
+{
+	__dint();
+	serial_usci_sleeping = 1;
+
+	while(serial_rb_full(serial_irq_tx)) {
+		__bis_SR_register(LPM0_bits + GIE);
+		__dint();
+	}
+
+	serial_usci_sleeping = 0;
+	__eint();
+
+	serial_port_write(port, &data, 1);
+}
+
+void serial_flow_init(unsigned short hwm, unsigned short lwm)
+{
+	serial_port_flow_init(SERIAL_PORT1, hwm, lwm);
+}
+
+void serial_port_flow_init(serial_port port, unsigned short hwm, unsigned short lwm)
+{
+	(void)port;
+
+	serial_irq_flow.hwm     = hwm;
+	serial_irq_flow.lwm     = lwm;
+	serial_irq_flow.stopped = 0;
+
+	/* RTS is driven by software from the RX ringbuffer level (low = ready). */
+	P2SEL &= ~SERIAL_RTS;
+	P2OUT &= ~SERIAL_RTS;
+	P2DIR |=  SERIAL_RTS;
+}
+
+void serial_port_flow_update(serial_port port)
+{
+	(void)port;
+
+	if(serial_irq_flow.stopped && serial_rb_used(serial_irq_rx) <= serial_irq_flow.lwm) {
+		serial_irq_flow.stopped = 0;
+		P2OUT &= ~SERIAL_RTS;
+	}
+}
+
+interrupt(USCIAB0RX_VECTOR) serial_irq_rx_isr(void)
+{
+	if((IFG2 & UCA0RXIFG) && serial_irq_rx) {
+		serial_rb_put(serial_irq_rx, UCA0RXBUF);
+
+		/* Ask the sender to pause when crossing the high watermark. */
+		if(serial_irq_flow.hwm != 0 && !serial_irq_flow.stopped &&
+		   serial_rb_used(serial_irq_rx) >= serial_irq_flow.hwm) {
+			serial_irq_flow.stopped = 1;
+			P2OUT |= SERIAL_RTS;
+		}
+
+		if(serial_usci_sleeping) {
+			__bic_SR_register_on_exit(LPM0_bits);
+		}
+	}
+}
+
+interrupt(USCIAB0TX_VECTOR) serial_irq_tx_isr(void)
+{
+	if(!serial_rb_empty(serial_irq_tx)) {
+		UCA0TXBUF = serial_rb_read(serial_irq_tx);
+
+		if(serial_usci_sleeping) {
+			__bic_SR_register_on_exit(LPM0_bits);
+		}
+	}
+	else {
+		/* Disable the TX interrupt, it's no longer needed. */
+		IE2 &= ~UCA0TXIE;
+	}
+}
@@ -0,0 +1,240 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "serial.h"
+#include "serial_irq.h"
+#include "serial_time.h"
+#include "serial_negotiate.h"
+
+/**
+ * Request from the master: 'N' + highest baudrate offered (LSB first)
+ */
+#define SERIAL_NEGOTIATE_REQ		'N'
+
+/**
+ * Answer from the slave: 'A' + baudrate to switch to (LSB first)
+ */
+#define SERIAL_NEGOTIATE_ACK		'A'
+
+/**
+ * Confirmation from the master after the test pattern came back
+ */
+#define SERIAL_NEGOTIATE_CONFIRM	'C'
+
+/**
+ * Acknowledgment from the slave for the confirmation, sent at the new baudrate
+ */
+#define SERIAL_NEGOTIATE_DONE		'D'
+
+/**
+ * Length of request and answer
+ */
+#define SERIAL_NEGOTIATE_MSG_LEN	5
+
+/**
+ * Baudrates which could be negotiated
+ */
+static const unsigned long serial_negotiate_rates[] = {
+	9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600
+};
+
+/**
+ * Test pattern sent at the new baudrate (edges at all bit positions)
+ */
+static const unsigned char serial_negotiate_pattern[8] = {
+	0x55, 0xAA, 0x00, 0xFF, 0x0F, 0xF0, 0x33, 0xCC
+};
+
+static unsigned long serial_negotiate_pick(unsigned long max)
+{
+	unsigned char i = sizeof(serial_negotiate_rates) / sizeof(serial_negotiate_rates[0]) - 1;
+
+	while(i > 0 && serial_negotiate_rates[i] > max) {
+		i--;
+	}
+
+	return serial_negotiate_rates[i];
+}
+
+static void serial_negotiate_flush(serial_port port)
+{
+	unsigned char c;
+
+	while(serial_port_read(port, &c, 1) == 1);
+}
+
+static void serial_negotiate_wait(unsigned short ms)
+{
+	unsigned long start = serial_time_ms();
+
+	while(serial_time_ms() - start < ms) {
+		serial_time_wait();
+	}
+}
+
+/**
+ * Switch from baudrate "from" to "to", after what was queued for sending
+ * (at most one message) has left the line.
+ */
+static int serial_negotiate_switch(serial_port port, long clkspeed, unsigned long from, unsigned long to)
+{
+	int err;
+
+	serial_negotiate_wait(2 + (unsigned short)(10UL * 10 * 1000 / from));
+
+	serial_port_clk_init(port, clkspeed, to);
+	serial_negotiate_flush(port);
+
+	err = serial_port_baud_error(port);
+
+	return (err <= SERIAL_NEGOTIATE_MAX_ERR && err >= -SERIAL_NEGOTIATE_MAX_ERR);
+}
+
+static int serial_negotiate_match(const unsigned char *data)
+{
+	unsigned char i;
+
+	for(i = 0; i < sizeof(serial_negotiate_pattern); i++) {
+		if(data[i] != serial_negotiate_pattern[i]) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+unsigned long serial_negotiate_master(long clkspeed, unsigned long max)
+{
+	return serial_port_negotiate_master(SERIAL_PORT1, clkspeed, max);
+}
+
+unsigned long serial_negotiate_slave(long clkspeed, unsigned long max, unsigned short ms)
+{
+	return serial_port_negotiate_slave(SERIAL_PORT1, clkspeed, max, ms);
+}
+
+unsigned long serial_port_negotiate_master(serial_port port, long clkspeed, unsigned long max)
+{
+	unsigned char msg[sizeof(serial_negotiate_pattern)];
+	unsigned long baud;
+
+	max = serial_negotiate_pick(max);
+
+	while(max > SERIAL_NEGOTIATE_BAUD) {
+		msg[0] = SERIAL_NEGOTIATE_REQ;
+		msg[1] = max;
+		msg[2] = max >> 8;
+		msg[3] = max >> 16;
+		msg[4] = max >> 24;
+
+		serial_negotiate_flush(port);
+		serial_port_write_timeout(port, msg, SERIAL_NEGOTIATE_MSG_LEN, SERIAL_NEGOTIATE_TIMEOUT);
+
+		if(serial_port_read_timeout(port, msg, SERIAL_NEGOTIATE_MSG_LEN, SERIAL_NEGOTIATE_TIMEOUT) !=
+		   SERIAL_NEGOTIATE_MSG_LEN || msg[0] != SERIAL_NEGOTIATE_ACK) {
+			break;
+		}
+
+		baud = msg[1] | ((unsigned long)msg[2] << 8) | ((unsigned long)msg[3] << 16) | ((unsigned long)msg[4] << 24);
+
+		if(baud <= SERIAL_NEGOTIATE_BAUD || baud > max) {
+			break;
+		}
+
+		if(serial_negotiate_switch(port, clkspeed, SERIAL_NEGOTIATE_BAUD, baud)) {
+			/* The slave started switching when sending its answer, make sure it is done. */
+			serial_negotiate_wait(5);
+
+			serial_port_write_timeout(port, serial_negotiate_pattern, sizeof(serial_negotiate_pattern),
+									  SERIAL_NEGOTIATE_TIMEOUT);
+
+			if(serial_port_read_timeout(port, msg, sizeof(msg), SERIAL_NEGOTIATE_TIMEOUT) == sizeof(msg) &&
+			   serial_negotiate_match(msg)) {
+				msg[0] = SERIAL_NEGOTIATE_CONFIRM;
+				serial_port_write_timeout(port, msg, 1, SERIAL_NEGOTIATE_TIMEOUT);
+
+				/* Only keep the new baudrate if the slave is known to keep it too. */
+				if(serial_port_recv_timeout(port, SERIAL_NEGOTIATE_TIMEOUT) == SERIAL_NEGOTIATE_DONE) {
+					return baud;
+				}
+			}
+		}
+
+		/*
+		 * Fall back, give the slave time to notice, then try the next lower baudrate.
+		 * If the slave already switched for good, it no longer answers at the start
+		 * baudrate and negotiation ends there.
+		 */
+		serial_negotiate_switch(port, clkspeed, baud, SERIAL_NEGOTIATE_BAUD);
+		serial_negotiate_wait(2 * SERIAL_NEGOTIATE_TIMEOUT);
+
+		max = serial_negotiate_pick(baud - 1);
+	}
+
+	return SERIAL_NEGOTIATE_BAUD;
+}
+
+unsigned long serial_port_negotiate_slave(serial_port port, long clkspeed, unsigned long max, unsigned short ms)
+{
+	unsigned char msg[sizeof(serial_negotiate_pattern)];
+	unsigned long start = serial_time_ms();
+	unsigned long baud;
+
+	while(serial_time_ms() - start < ms) {
+		if(serial_port_recv_timeout(port, SERIAL_NEGOTIATE_TIMEOUT) != SERIAL_NEGOTIATE_REQ ||
+		   serial_port_read_timeout(port, msg, SERIAL_NEGOTIATE_MSG_LEN - 1, SERIAL_NEGOTIATE_TIMEOUT) !=
+		   SERIAL_NEGOTIATE_MSG_LEN - 1) {
+			continue;
+		}
+
+		baud = msg[0] | ((unsigned long)msg[1] << 8) | ((unsigned long)msg[2] << 16) | ((unsigned long)msg[3] << 24);
+		baud = serial_negotiate_pick(baud < max ? baud : max);
+
+		msg[0] = SERIAL_NEGOTIATE_ACK;
+		msg[1] = baud;
+		msg[2] = baud >> 8;
+		msg[3] = baud >> 16;
+		msg[4] = baud >> 24;
+
+		serial_port_write_timeout(port, msg, SERIAL_NEGOTIATE_MSG_LEN, SERIAL_NEGOTIATE_TIMEOUT);
+
+		if(baud == SERIAL_NEGOTIATE_BAUD) {
+			break;
+		}
+
+		if(serial_negotiate_switch(port, clkspeed, SERIAL_NEGOTIATE_BAUD, baud) &&
+		   serial_port_read_timeout(port, msg, sizeof(msg), SERIAL_NEGOTIATE_TIMEOUT) == sizeof(msg) &&
+		   serial_negotiate_match(msg)) {
+
+			serial_port_write_timeout(port, msg, sizeof(msg), SERIAL_NEGOTIATE_TIMEOUT);
+
+			if(serial_port_recv_timeout(port, SERIAL_NEGOTIATE_TIMEOUT) == SERIAL_NEGOTIATE_CONFIRM) {
+				msg[0] = SERIAL_NEGOTIATE_DONE;
+				serial_port_write_timeout(port, msg, 1, SERIAL_NEGOTIATE_TIMEOUT);
+
+				return baud;
+			}
+		}
+
+		/* Test failed, wait for the master to retry at the start baudrate. */
+		serial_negotiate_switch(port, clkspeed, baud, SERIAL_NEGOTIATE_BAUD);
+	}
+
+	return SERIAL_NEGOTIATE_BAUD;
+}
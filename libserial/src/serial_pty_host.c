@@ -0,0 +1,178 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "serial.h"
+#include "serial_pty_host.h"
+
+/**
+ * Master side of the pseudo-terminal of each port (-1 if not initialized)
+ */
+int serial_pty_fds[SERIAL_PORTS] = { -1, -1, -1 };
+
+void serial_init(unsigned long baudrate)
+{
+	serial_port_clk_init(SERIAL_PORT1, 0, baudrate);
+}
+
+void serial_clk_init(long clkspeed, unsigned long baudrate)
+{
+	serial_port_clk_init(SERIAL_PORT1, clkspeed, baudrate);
+}
+
+int serial_baud_error()
+{
+	return serial_port_baud_error(SERIAL_PORT1);
+}
+
+void serial_send(unsigned char data)
+{
+	serial_port_send(SERIAL_PORT1, data);
+}
+
+void serial_send_blocking(unsigned char data)
+{
+	serial_port_send_blocking(SERIAL_PORT1, data);
+}
+
+unsigned char serial_recv()
+{
+	return serial_port_recv(SERIAL_PORT1);
+}
+
+unsigned char serial_recv_blocking()
+{
+	return serial_port_recv_blocking(SERIAL_PORT1);
+}
+
+void serial_port_init(serial_port port, unsigned long baudrate)
+{
+	serial_port_clk_init(port, 0, baudrate);
+}
+
+void serial_port_clk_init(serial_port port, long clkspeed, unsigned long baudrate)
+{
+	struct termios tio;
+	int fd;
+	int sfd;
+
+	(void)clkspeed;
+	(void)baudrate;
+
+	if(serial_pty_fds[port] >= 0) {
+		return;
+	}
+
+	fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+	if(fd < 0 || grantpt(fd) < 0 || unlockpt(fd) < 0) {
+		perror("libserial: posix_openpt");
+		exit(1);
+	}
+
+	/*
+	 * Keep the slave side open, so the master does not see a hangup while
+	 * no peer is connected, and put it into raw mode (8,N,1, no echo).
+	 */
+	sfd = open(ptsname(fd), O_RDWR | O_NOCTTY);
+
+	if(sfd < 0) {
+		perror("libserial: open pty slave");
+		exit(1);
+	}
+
+	tcgetattr(sfd, &tio);
+	cfmakeraw(&tio);
+	tcsetattr(sfd, TCSANOW, &tio);
+
+	serial_pty_fds[port] = fd;
+
+	fprintf(stderr, "libserial: SERIAL_PORT%d on %s\n", port + 1, ptsname(fd));
+}
+
+/**
+ * Wait until the pty of the given port is ready for the given events
+ * (the fd is non-blocking when interrupt driven mode is used).
+ */
+static void serial_pty_wait(serial_port port, short events)
+{
+	struct pollfd pfd;
+
+	pfd.fd     = serial_pty_fds[port];
+	pfd.events = events;
+
+	while(poll(&pfd, 1, -1) != 1);
+}
+
+void serial_port_send(serial_port port, unsigned char data)
+{
+	serial_port_send_blocking(port, data);
+}
+
+void serial_port_send_blocking(serial_port port, unsigned char data)
+{
+	do {
+		serial_pty_wait(port, POLLOUT);
+	} while(write(serial_pty_fds[port], &data, 1) != 1);
+}
+
+unsigned char serial_port_recv(serial_port port)
+{
+	struct pollfd pfd;
+	unsigned char data = 0;
+
+	/* Like reading the data register, returns garbage if nothing was received. */
+	pfd.fd     = serial_pty_fds[port];
+	pfd.events = POLLIN;
+
+	if(poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN)) {
+		if(read(serial_pty_fds[port], &data, 1) != 1) {
+			data = 0;
+		}
+	}
+
+	return data;
+}
+
+unsigned char serial_port_recv_blocking(serial_port port)
+{
+	unsigned char data;
+
+	do {
+		serial_pty_wait(port, POLLIN);
+	} while(read(serial_pty_fds[port], &data, 1) != 1);
+
+	return data;
+}
+
+int serial_port_baud_error(serial_port port)
+{
+	(void)port;
+
+	/* a pty has no baudrate generator */
+	return 0;
+}
@@ -0,0 +1,31 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERIAL_PTY_HOST_H_
+#define __SERIAL_PTY_HOST_H_
+
+#include "serial.h"
+
+/**
+ * Master side of the pseudo-terminal of each port, indexed by SERIAL_PORT*
+ * (library internal, -1 if not initialized).
+ */
+extern int serial_pty_fds[SERIAL_PORTS];
+
+#endif
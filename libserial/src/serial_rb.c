@@ -17,50 +17,335 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdint.h>
+
 #include "serial_rb.h"
 
+/**
+ * Machine word used for scanning the buffer for line delimiters
+ */
+typedef unsigned int __attribute__((__may_alias__)) serial_rb_word;
+
+/**
+ * Word with every byte set to b
+ */
+#define SERIAL_RB_BYTES(b)	((serial_rb_word)-1 / 0xFF * (b))
+
+/**
+ * Non-zero if any byte of the word v is zero
+ */
+#define SERIAL_RB_HASZERO(v)	(((v) - SERIAL_RB_BYTES(0x01)) & ~(v) & SERIAL_RB_BYTES(0x80))
+
+/**
+ * Non-zero if any byte of the word v is CR or LF
+ */
+#define SERIAL_RB_HASEOL(v)	(SERIAL_RB_HASZERO((v) ^ SERIAL_RB_BYTES('\r')) | \
+							 SERIAL_RB_HASZERO((v) ^ SERIAL_RB_BYTES('\n')))
+
+static void serial_rb_copy(SERIAL_RB_Q *dst, const SERIAL_RB_Q *src, unsigned short len)
+{
+    while(len--) *(dst++) = *(src++);
+}
+
+static void serial_rb_account(serial_rb *rb, unsigned short len)
+{
+    unsigned short used = serial_rb_used(rb);
+
+    rb->stats.enqueued += len;
+
+    if(used > rb->stats.hwm) rb->stats.hwm = used;
+}
+
+static void serial_rb_skip_overwritten(serial_rb *rb)
+{
+    unsigned short w = rb->write;
+
+    // producer lapped the consumer, continue with the oldest element left
+    if((unsigned short)(w - rb->read) > rb->elements) {
+        rb->read = w - rb->elements;
+    }
+}
+
+unsigned short serial_rb_used(serial_rb *rb)
+{
+    unsigned short used = rb->write - rb->read;
+
+    // could exceed the buffer size with SERIAL_RB_POLICY_OVERWRITE
+    return (used > rb->elements ? rb->elements : used);
+}
+
 unsigned short serial_rb_free(serial_rb *rb)
 {
-    return (rb->elements - rb->entries);
+    return (rb->elements - serial_rb_used(rb));
 }
 
 int serial_rb_full(serial_rb *rb)
 {
-    return (rb->elements == rb->entries);
+    return (serial_rb_used(rb) == rb->elements);
 }
 
 int serial_rb_empty(serial_rb *rb)
 {
-    return (rb->entries == 0);
+    return (rb->write == rb->read);
 }
 
 void serial_rb_init(serial_rb *rb, SERIAL_RB_Q *buffer, unsigned short elements)
 {
+    unsigned short size = 0x8000;
+
+    // only power of two sizes could be masked, at least one element (a size
+    // of 0 would give a mask of 0xFFFF)
+    while(size > elements && size > 1) size >>= 1;
+
     rb->buffer      = buffer;
-    rb->read        = &(rb->buffer[0]);
-    rb->write       = &(rb->buffer[0]);
-    rb->elements    = elements;
-    rb->entries     = 0;
+    rb->read        = 0;
+    rb->write       = 0;
+    rb->elements    = size;
+    rb->mask        = size - 1;
+    rb->policy      = SERIAL_RB_POLICY_DROP;
+
+    serial_rb_stats_clear(rb);
+}
+
+void serial_rb_set_policy(serial_rb *rb, unsigned char policy)
+{
+    rb->policy = policy;
+}
+
+void serial_rb_stats_clear(serial_rb *rb)
+{
+    rb->stats.hwm       = 0;
+    rb->stats.enqueued  = 0;
+    rb->stats.dropped   = 0;
 }
 
 void serial_rb_write(serial_rb *rb, SERIAL_RB_Q element)
 {
-  rb->entries++;
+  unsigned short w = rb->write;
 
-  if (rb->write > &(rb->buffer[rb->elements - 1])) {
-      rb->write = &(rb->buffer[0]);
+  rb->buffer[w & rb->mask] = element;
+
+  // element must be in memory before the consumer sees the new index
+  SERIAL_RB_BARRIER();
+
+  rb->write = w + 1;
+
+  serial_rb_account(rb, 1);
+}
+
+int serial_rb_put(serial_rb *rb, SERIAL_RB_Q element)
+{
+  if(serial_rb_full(rb)) {
+    rb->stats.dropped++;
+
+    if(rb->policy == SERIAL_RB_POLICY_DROP) {
+      return 0;
+    }
+    if(rb->policy == SERIAL_RB_POLICY_REJECT) {
+      return -1;
+    }
   }
 
-  *(rb->write++) = element;
+  serial_rb_write(rb, element);
+
+  return 0;
 }
 
 SERIAL_RB_Q serial_rb_read(serial_rb *rb)
 {
-  rb->entries--;
+  unsigned short r;
+  SERIAL_RB_Q element;
+
+  if(rb->policy == SERIAL_RB_POLICY_OVERWRITE) {
+    serial_rb_skip_overwritten(rb);
+  }
+
+  r = rb->read;
+
+  element = rb->buffer[r & rb->mask];
+
+  // element must be fetched before the producer is allowed to reuse the slot
+  SERIAL_RB_BARRIER();
+
+  rb->read = r + 1;
+
+  return element;
+}
+
+SERIAL_RB_Q *serial_rb_reserve(serial_rb *rb, unsigned short *len)
+{
+  unsigned short pos = rb->write & rb->mask;
+  unsigned short seg = rb->elements - pos;
+  unsigned short free = serial_rb_free(rb);
+
+  *len = (seg < free ? seg : free);
+
+  return &(rb->buffer[pos]);
+}
+
+void serial_rb_commit(serial_rb *rb, unsigned short len)
+{
+  // elements must be in memory before the consumer sees the new index
+  SERIAL_RB_BARRIER();
+
+  rb->write += len;
+
+  serial_rb_account(rb, len);
+}
+
+SERIAL_RB_Q *serial_rb_peek(serial_rb *rb, unsigned short *len)
+{
+  unsigned short pos;
+  unsigned short seg;
+  unsigned short used;
+
+  if(rb->policy == SERIAL_RB_POLICY_OVERWRITE) {
+    serial_rb_skip_overwritten(rb);
+  }
+
+  pos  = rb->read & rb->mask;
+  seg  = rb->elements - pos;
+  used = serial_rb_used(rb);
+
+  *len = (seg < used ? seg : used);
+
+  return &(rb->buffer[pos]);
+}
+
+void serial_rb_consume(serial_rb *rb, unsigned short len)
+{
+  // elements must be fetched before the producer is allowed to reuse the slots
+  SERIAL_RB_BARRIER();
+
+  rb->read += len;
+}
+
+unsigned short serial_rb_write_block(serial_rb *rb, const SERIAL_RB_Q *data, unsigned short len)
+{
+  unsigned short done = 0;
+  unsigned short seg;
+  SERIAL_RB_Q *span;
+
+  // first segment up to the end of the buffer, second one from the start
+  while(done < len) {
+    span = serial_rb_reserve(rb, &seg);
+
+    if(seg == 0) break;
+    if(seg > len - done) seg = len - done;
+
+    serial_rb_copy(span, data + done, seg);
+    serial_rb_commit(rb, seg);
+
+    done += seg;
+  }
+
+  return done;
+}
+
+unsigned short serial_rb_read_block(serial_rb *rb, SERIAL_RB_Q *data, unsigned short len)
+{
+  unsigned short done = 0;
+  unsigned short seg;
+  SERIAL_RB_Q *span;
+
+  while(done < len) {
+    span = serial_rb_peek(rb, &seg);
+
+    if(seg == 0) break;
+    if(seg > len - done) seg = len - done;
+
+    serial_rb_copy(data + done, span, seg);
+    serial_rb_consume(rb, seg);
+
+    done += seg;
+  }
+
+  return done;
+}
+
+static unsigned short serial_rb_scan(const SERIAL_RB_Q *p, unsigned short len)
+{
+  unsigned short i = 0;
+  serial_rb_word v;
+
+  // bytewise up to the first aligned word
+  while(i < len && ((uintptr_t)(p + i) & (sizeof(serial_rb_word) - 1)) != 0) {
+    if(p[i] == '\r' || p[i] == '\n') return i;
+    i++;
+  }
+
+  // word-at-a-time until a word holds a delimiter
+  while((unsigned int)(len - i) >= sizeof(serial_rb_word)) {
+    v = *(const serial_rb_word *)(p + i);
+
+    if(SERIAL_RB_HASEOL(v)) break;
+
+    i += sizeof(serial_rb_word);
+  }
+
+  // bytewise within the matching word and the rest
+  while(i < len) {
+    if(p[i] == '\r' || p[i] == '\n') return i;
+    i++;
+  }
+
+  return len;
+}
+
+char *serial_rb_readline(serial_rb *rb, char *buf, unsigned short size, unsigned short *len)
+{
+  SERIAL_RB_Q *span;
+  unsigned short seg;
+  unsigned short used;
+  unsigned short pos;
+
+  // no room for the terminating zero of a wrapped line
+  if(size == 0) return 0;
+
+  // skip what is left over from the previous line (e.g. LF of CR/LF)
+  while(1) {
+    span = serial_rb_peek(rb, &seg);
+
+    if(seg == 0) return 0;
+    if(*span != '\r' && *span != '\n') break;
+
+    serial_rb_consume(rb, 1);
+  }
+
+  // line is contiguous, terminate it in place
+  pos = serial_rb_scan(span, seg);
+
+  if(pos < seg) {
+    span[pos] = 0;
+    *len      = pos + 1;
+
+    return (char *)span;
+  }
+
+  // line may continue at the start of the buffer memory
+  used = serial_rb_used(rb);
+
+  if(used > seg) {
+    pos = serial_rb_scan(rb->buffer, used - seg);
+
+    if(pos < used - seg) {
+      *len = seg + pos + 1;
+
+      if(seg > size - 1) seg = size - 1;
+      if(pos > size - 1 - seg) pos = size - 1 - seg;
+
+      serial_rb_copy((SERIAL_RB_Q *)buf, span, seg);
+      serial_rb_copy((SERIAL_RB_Q *)buf + seg, rb->buffer, pos);
+      buf[seg + pos] = 0;
+
+      return buf;
+    }
+  }
 
-  if (rb->read > &(rb->buffer[rb->elements - 1])) {
-      rb->read = &(rb->buffer[0]);
+  // line never fits, drop it
+  if(used == rb->elements) {
+    serial_rb_consume(rb, used);
   }
 
-  return *(rb->read++);
+  return 0;
 }
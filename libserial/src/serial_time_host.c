@@ -0,0 +1,51 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _GNU_SOURCE
+
+#include <time.h>
+
+#include "serial_time.h"
+
+static struct timespec serial_time_start;
+
+void serial_time_init(unsigned long clkspeed)
+{
+	(void)clkspeed;
+
+	clock_gettime(CLOCK_MONOTONIC, &serial_time_start);
+}
+
+unsigned long serial_time_ms()
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (unsigned long)((now.tv_sec - serial_time_start.tv_sec) * 1000L +
+						   (now.tv_nsec - serial_time_start.tv_nsec) / 1000000L);
+}
+
+void serial_time_wait()
+{
+	/* There is no interrupt to wait for, sleep for a fraction of a tick. */
+	struct timespec ts = { 0, 100000L };
+
+	nanosleep(&ts, 0);
+}
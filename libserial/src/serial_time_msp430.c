@@ -0,0 +1,68 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <msp430.h>
+#include <legacymsp430.h>
+
+#include "serial_time.h"
+#include "serial_usci_msp430.h"
+
+static volatile unsigned long serial_time_ticks = 0;
+
+void serial_time_init(unsigned long clkspeed)
+{
+	/* SMCLK/8, up mode, one interrupt per millisecond. */
+	TA1CCR0  = clkspeed / 8000 - 1;
+	TA1CCTL0 = CCIE;
+	TA1CTL   = TASSEL_2 + ID_3 + MC_1 + TACLR;
+
+	__bis_SR_register(GIE);
+}
+
+unsigned long serial_time_ms()
+{
+	unsigned long ms;
+
+	/* The counter is updated by the ISR in two 16 bit halves. */
+	do {
+		ms = serial_time_ticks;
+	} while(ms != serial_time_ticks);
+
+	return ms;
+}
+
+void serial_time_wait()
+{
+	/*
+	 * The flag is shared with the USCI ISRs, thus a received or sent byte
+	 * also ends the wait (not only the next tick).
+	 */
+	serial_usci_sleeping = 1;
+	__bis_SR_register(LPM0_bits + GIE);
+	serial_usci_sleeping = 0;
+}
+
+interrupt(TIMER1_A0_VECTOR) serial_time_isr(void)
+{
+	serial_time_ticks++;
+
+	if(serial_usci_sleeping) {
+		__bic_SR_register_on_exit(LPM0_bits);
+	}
+}
@@ -0,0 +1,48 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <libopencm3/stm32/systick.h>
+
+#include "serial_time.h"
+
+static volatile unsigned long serial_time_ticks = 0;
+
+void serial_time_init(unsigned long clkspeed)
+{
+	/* One interrupt per millisecond. */
+	systick_set_clocksource(STK_CTRL_CLKSOURCE_AHB_DIV8);
+	systick_set_reload(clkspeed / 8000 - 1);
+	systick_interrupt_enable();
+	systick_counter_enable();
+}
+
+unsigned long serial_time_ms()
+{
+	return serial_time_ticks;
+}
+
+void serial_time_wait()
+{
+	__asm__ volatile ("wfi");
+}
+
+void sys_tick_handler(void)
+{
+	serial_time_ticks++;
+}
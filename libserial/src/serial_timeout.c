@@ -0,0 +1,90 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "serial.h"
+#include "serial_irq.h"
+#include "serial_time.h"
+
+/*
+ * The timeout functions only use the interrupt driven ringbuffers and the
+ * time base, thus they are the same for all targets. While waiting, the CPU
+ * sleeps until the next interrupt (a received/sent byte or the next tick).
+ */
+
+int serial_recv_timeout(unsigned short ms)
+{
+	return serial_port_recv_timeout(SERIAL_PORT1, ms);
+}
+
+unsigned short serial_read_timeout(unsigned char *data, unsigned short len, unsigned short ms)
+{
+	return serial_port_read_timeout(SERIAL_PORT1, data, len, ms);
+}
+
+unsigned short serial_write_timeout(const unsigned char *data, unsigned short len, unsigned short ms)
+{
+	return serial_port_write_timeout(SERIAL_PORT1, data, len, ms);
+}
+
+int serial_port_recv_timeout(serial_port port, unsigned short ms)
+{
+	unsigned char data;
+
+	if(serial_port_read_timeout(port, &data, 1, ms) == 0) {
+		return -1;
+	}
+
+	return data;
+}
+
+unsigned short serial_port_read_timeout(serial_port port, unsigned char *data, unsigned short len, unsigned short ms)
+{
+	unsigned long start = serial_time_ms();
+	unsigned short n    = 0;
+
+	while(1) {
+		n += serial_port_read(port, &(data[n]), len - n);
+
+		if(n == len || serial_time_ms() - start >= ms) {
+			break;
+		}
+
+		serial_time_wait();
+	}
+
+	return n;
+}
+
+unsigned short serial_port_write_timeout(serial_port port, const unsigned char *data, unsigned short len, unsigned short ms)
+{
+	unsigned long start = serial_time_ms();
+	unsigned short n    = 0;
+
+	while(1) {
+		n += serial_port_write(port, &(data[n]), len - n);
+
+		if(n == len || serial_time_ms() - start >= ms) {
+			break;
+		}
+
+		serial_time_wait();
+	}
+
+	return n;
+}
@@ -20,54 +20,159 @@
 #include <libopencm3/stm32/f1/rcc.h>
 #include <libopencm3/stm32/usart.h>
 #include <libopencm3/stm32/f1/gpio.h>
+#include <libopencm3/stm32/f1/nvic.h>
 
 #include "serial.h"
+#include "serial_usart_stm32.h"
 
-void serial_init(unsigned int baudrate)
+const serial_usart_port serial_usart_ports[SERIAL_PORTS] = {
+	{
+		.usart       = USART1,
+		.rcc_reg     = &RCC_APB2ENR,
+		.rcc_en      = RCC_APB2ENR_USART1EN,
+		.rcc_gpio_en = RCC_APB2ENR_IOPAEN,
+		.gpio        = GPIOA,
+		.tx          = GPIO_USART1_TX,
+		.rx          = GPIO_USART1_RX,
+		.cts         = GPIO_USART1_CTS,
+		.rts         = GPIO_USART1_RTS,
+		.irq         = NVIC_USART1_IRQ,
+	},
+	{
+		.usart       = USART2,
+		.rcc_reg     = &RCC_APB1ENR,
+		.rcc_en      = RCC_APB1ENR_USART2EN,
+		.rcc_gpio_en = RCC_APB2ENR_IOPAEN,
+		.gpio        = GPIOA,
+		.tx          = GPIO_USART2_TX,
+		.rx          = GPIO_USART2_RX,
+		.cts         = GPIO_USART2_CTS,
+		.rts         = GPIO_USART2_RTS,
+		.irq         = NVIC_USART2_IRQ,
+	},
+	{
+		.usart       = USART3,
+		.rcc_reg     = &RCC_APB1ENR,
+		.rcc_en      = RCC_APB1ENR_USART3EN,
+		.rcc_gpio_en = RCC_APB2ENR_IOPBEN,
+		.gpio        = GPIOB,
+		.tx          = GPIO_USART3_TX,
+		.rx          = GPIO_USART3_RX,
+		.cts         = GPIO_USART3_CTS,
+		.rts         = GPIO_USART3_RTS,
+		.irq         = NVIC_USART3_IRQ,
+	},
+};
+
+/**
+ * Error of the baudrate set up by serial_port_clk_init for each port
+ */
+static int serial_usart_err[SERIAL_PORTS];
+
+void serial_init(unsigned long baudrate)
 {
-	serial_clk_init(0, baudrate);
+	serial_port_clk_init(SERIAL_PORT1, 0, baudrate);
 }
 
-void serial_clk_init(long clkspeed, unsigned int baudrate)
+void serial_clk_init(long clkspeed, unsigned long baudrate)
 {
-	/* Enable clock for USART1. */
-	rcc_peripheral_enable_clock(&RCC_APB2ENR, RCC_APB2ENR_IOPAEN | RCC_APB2ENR_USART1EN);
+	serial_port_clk_init(SERIAL_PORT1, clkspeed, baudrate);
+}
 
-	/* Setup GPIO pin GPIO_USART1_TX. */
-	gpio_set_mode(GPIOA, GPIO_MODE_OUTPUT_50_MHZ,
-		      GPIO_CNF_OUTPUT_ALTFN_PUSHPULL, GPIO_USART1_TX);
+int serial_baud_error()
+{
+	return serial_port_baud_error(SERIAL_PORT1);
+}
 
-	/* Setup GPIO pin GPIO_USART1_RX. */
-    gpio_set_mode(GPIOA, GPIO_MODE_INPUT, GPIO_CNF_INPUT_FLOAT, GPIO_USART1_RX);
+void serial_send(unsigned char data)
+{
+	serial_port_send(SERIAL_PORT1, data);
+}
+
+void serial_send_blocking(unsigned char data)
+{
+	serial_port_send_blocking(SERIAL_PORT1, data);
+}
+
+unsigned char serial_recv()
+{
+	return serial_port_recv(SERIAL_PORT1);
+}
+
+unsigned char serial_recv_blocking()
+{
+	return serial_port_recv_blocking(SERIAL_PORT1);
+}
+
+void serial_port_init(serial_port port, unsigned long baudrate)
+{
+	serial_port_clk_init(port, 0, baudrate);
+}
+
+void serial_port_clk_init(serial_port port, long clkspeed, unsigned long baudrate)
+{
+	const serial_usart_port *p = &serial_usart_ports[port];
+	unsigned long clock;
+	unsigned long brr;
+	unsigned long cts;
+
+	(void)clkspeed;
+
+	/* Keep CTS flow control when re-initialized (e.g. new baudrate). */
+	cts = USART_CR3(p->usart) & USART_CR3_CTSE;
+
+	/* Enable clock for the GPIO port and the USART. */
+	rcc_peripheral_enable_clock(&RCC_APB2ENR, p->rcc_gpio_en);
+	rcc_peripheral_enable_clock(p->rcc_reg, p->rcc_en);
+
+	/* Setup GPIO pin for TX. */
+	gpio_set_mode(p->gpio, GPIO_MODE_OUTPUT_50_MHZ,
+		      GPIO_CNF_OUTPUT_ALTFN_PUSHPULL, p->tx);
+
+	/* Setup GPIO pin for RX. */
+    gpio_set_mode(p->gpio, GPIO_MODE_INPUT, GPIO_CNF_INPUT_FLOAT, p->rx);
 
 	/* Setup UART parameters. */
-	usart_set_baudrate(USART1, baudrate);
-	usart_set_databits(USART1, 8);
-	usart_set_stopbits(USART1, USART_STOPBITS_1);
-	usart_set_mode(USART1, USART_MODE_TX_RX);
-	usart_set_parity(USART1, USART_PARITY_NONE);
-	usart_set_flow_control(USART1, USART_FLOWCONTROL_NONE);
+	usart_set_baudrate(p->usart, baudrate);
+
+	/* Same divisor as calculated by usart_set_baudrate (APB2 for USART1). */
+	clock = (p->usart == USART1 ? rcc_ppre2_frequency : rcc_ppre1_frequency);
+	brr   = ((2 * clock) + baudrate) / (2 * baudrate);
+
+	serial_usart_err[port] = ((long)(clock - brr * baudrate) * 100L) / (long)(brr * baudrate / 100);
+
+	usart_set_databits(p->usart, 8);
+	usart_set_stopbits(p->usart, USART_STOPBITS_1);
+	usart_set_mode(p->usart, USART_MODE_TX_RX);
+	usart_set_parity(p->usart, USART_PARITY_NONE);
+	usart_set_flow_control(p->usart, USART_FLOWCONTROL_NONE);
+	USART_CR3(p->usart) |= cts;
 
 	/* Finally enable the USART. */
-	usart_enable(USART1);
+	usart_enable(p->usart);
 }
 
-void serial_send(unsigned char data)
+void serial_port_send(serial_port port, unsigned char data)
 {
-	usart_send(USART1, data);
+	usart_send(serial_usart_ports[port].usart, data);
 }
 
-void serial_send_blocking(unsigned char data)
+void serial_port_send_blocking(serial_port port, unsigned char data)
 {
-	usart_send_blocking(USART1, data);
+	usart_send_blocking(serial_usart_ports[port].usart, data);
 }
 
-unsigned char serial_recv()
+unsigned char serial_port_recv(serial_port port)
 {
-	return usart_recv(USART1);
+	return usart_recv(serial_usart_ports[port].usart);
 }
 
-unsigned char serial_recv_blocking()
+unsigned char serial_port_recv_blocking(serial_port port)
+{
+	return usart_recv_blocking(serial_usart_ports[port].usart);
+}
+
+int serial_port_baud_error(serial_port port)
 {
-	return usart_recv_blocking(USART1);
+	return serial_usart_err[port];
 }
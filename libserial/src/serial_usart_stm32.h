@@ -0,0 +1,92 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERIAL_USART_STM32_H_
+#define __SERIAL_USART_STM32_H_
+
+#include "serial.h"
+
+/**
+ * Hardware description of a serial port (library internal).
+ */
+typedef struct {
+	/**
+ 	 * USART base address
+ 	 */
+	unsigned long usart;
+
+	/**
+ 	 * RCC enable register of the USART
+ 	 */
+	volatile unsigned long *rcc_reg;
+
+	/**
+ 	 * RCC enable bits of the USART
+ 	 */
+	unsigned long rcc_en;
+
+	/**
+ 	 * RCC enable bits of the GPIO port (always on APB2)
+ 	 */
+	unsigned long rcc_gpio_en;
+
+	/**
+ 	 * GPIO port of the RX/TX pins
+ 	 */
+	unsigned long gpio;
+
+	/**
+ 	 * TX pin
+ 	 */
+	unsigned short tx;
+
+	/**
+ 	 * RX pin
+ 	 */
+	unsigned short rx;
+
+	/**
+ 	 * CTS pin (same GPIO port as RX/TX)
+ 	 */
+	unsigned short cts;
+
+	/**
+ 	 * RTS pin (same GPIO port as RX/TX)
+ 	 */
+	unsigned short rts;
+
+	/**
+ 	 * NVIC interrupt number of the USART
+ 	 */
+	unsigned char irq;
+} serial_usart_port;
+
+/**
+ * Hardware description of all serial ports, indexed by SERIAL_PORT*.
+ */
+extern const serial_usart_port serial_usart_ports[SERIAL_PORTS];
+
+/**
+ * Per port function called from the shared USART ISR when the IDLE
+ * interrupt is enabled and the line went idle (library internal). The
+ * IDLE flag is already cleared when the hook is called.
+ */
+extern void (*serial_irq_idle_hook[SERIAL_PORTS])(void);
+
+#endif
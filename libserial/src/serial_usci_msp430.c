@@ -23,6 +23,7 @@
 #include <stdbool.h>
 
 #include "serial.h"
+#include "serial_usci_msp430.h"
 
 /**
  * RXD pin
@@ -34,80 +35,118 @@
  */
 #define UART_TXD   		BIT2	
 
-void serial_init(unsigned int baudrate)
+/**
+ * Error of the baudrate set up by serial_port_clk_init
+ */
+static int serial_usci_err = 0;
+
+volatile unsigned char serial_usci_sleeping = 0;
+
+void serial_init(unsigned long baudrate)
+{
+	serial_port_clk_init(SERIAL_PORT1, 1000000L, baudrate);
+}
+
+void serial_clk_init(long clkspeed, unsigned long baudrate)
 {
-	serial_clk_init(1000000L, baudrate);
+	serial_port_clk_init(SERIAL_PORT1, clkspeed, baudrate);
 }
 
-void serial_clk_init(long clkspeed, unsigned int baudrate)
+int serial_baud_error()
 {
+	return serial_port_baud_error(SERIAL_PORT1);
+}
+
+void serial_send(unsigned char data)
+{
+	serial_port_send(SERIAL_PORT1, data);
+}
+
+void serial_send_blocking(unsigned char data)
+{
+	serial_port_send_blocking(SERIAL_PORT1, data);
+}
+
+unsigned char serial_recv()
+{
+	return serial_port_recv(SERIAL_PORT1);
+}
+
+unsigned char serial_recv_blocking()
+{
+	return serial_port_recv_blocking(SERIAL_PORT1);
+}
+
+/*
+ * The MSP430G2553 only has USCI_A0 as UART, thus the port handle is
+ * ignored by the serial_port_* functions.
+ */
+
+void serial_port_init(serial_port port, unsigned long baudrate)
+{
+	serial_port_clk_init(port, 1000000L, baudrate);
+}
+
+void serial_port_clk_init(serial_port port, long clkspeed, unsigned long baudrate)
+{
+	unsigned int  br;
+	unsigned char mctl;
+	unsigned char ie;
+
+	(void)port;
+
+	/* Hold the USCI in reset while changing the baudrate (also clears its IEs). */
+	ie        = IE2 & (UCA0RXIE | UCA0TXIE);
+	UCA0CTL1 |= UCSWRST;
+
 	P1SEL    |= UART_RXD + UART_TXD;                       
   	P1SEL2   |= UART_RXD + UART_TXD;                       
   	UCA0CTL1 |= UCSSEL_2; 
 
-	switch(clkspeed) {
-		case  1000000L:
-			switch(baudrate) {
-				case   9600: UCA0BR0 = 0x06; UCA0MCTL = 0x81; break;
-				case  19200: UCA0BR0 = 0x03; UCA0MCTL = 0x41; break;
-				case  57600: UCA0BR0 = 0x01; UCA0MCTL = 0x0F; break;
-				default    : UCA0BR0 = 0x06; UCA0MCTL = 0x81; break;
-			};
-			break;
-		case  8000000L:
-			switch(baudrate) {
-				case   9600: UCA0BR0 = 0x34; UCA0MCTL = 0x11; break;
-				case  19200: UCA0BR0 = 0x1a; UCA0MCTL = 0x11; break;
-				case  38400: UCA0BR0 = 0x0d; UCA0MCTL = 0x01; break;
-				case  57600: UCA0BR0 = 0x08; UCA0MCTL = 0xb1; break;
-				case 115200: UCA0BR0 = 0x04; UCA0MCTL = 0x3b; break;
-				case 230400: UCA0BR0 = 0x02; UCA0MCTL = 0x27; break;	
-				default    : UCA0BR0 = 0x34; UCA0MCTL = 0x11; break;
-			};
-			break;
-		case 16000000L:
-			switch(baudrate) {
-				case   9600: UCA0BR0 = 0x68; UCA0MCTL = 0x31; break;
-				case  19200: UCA0BR0 = 0x34; UCA0MCTL = 0x11; break;
-				case  38400: UCA0BR0 = 0x1a; UCA0MCTL = 0x11; break;
-				case  57600: UCA0BR0 = 0x11; UCA0MCTL = 0x61; break;
-				case 115200: UCA0BR0 = 0x08; UCA0MCTL = 0xb1; break;
-				case 230400: UCA0BR0 = 0x04; UCA0MCTL = 0x3b; break;	
-				default    : UCA0BR0 = 0x68; UCA0MCTL = 0x31; break;
-			};
-			break;
-		default:
-			switch(baudrate) {
-				case   9600: UCA0BR0 = 0x06; UCA0MCTL = 0x81; break;
-				case  19200: UCA0BR0 = 0x03; UCA0MCTL = 0x41; break;
-				case  57600: UCA0BR0 = 0x01; UCA0MCTL = 0x0F; break;
-				default    : UCA0BR0 = 0x06; UCA0MCTL = 0x81; break;
-			};
-			break;
-	}
- 
-  	UCA0BR1   = 0;
+	serial_usci_err = serial_usci_baud(clkspeed, baudrate, &br, &mctl);
+
+	UCA0BR0   = br & 0xFF;
+	UCA0BR1   = br >> 8;
+	UCA0MCTL  = mctl;
   	UCA0CTL1 &= ~UCSWRST; 
+
+	/* Re-initialized while interrupt driven (e.g. new baudrate). */
+	IE2      |= ie;
 }
 
-void serial_send(unsigned char data)
+int serial_port_baud_error(serial_port port)
+{
+	(void)port;
+
+	return serial_usci_err;
+}
+
+void serial_port_send(serial_port port, unsigned char data)
 {
+	(void)port;
+
   	UCA0TXBUF = data;                 		
 }
 
-void serial_send_blocking(unsigned char data)
+void serial_port_send_blocking(serial_port port, unsigned char data)
 {
+	(void)port;
+
 	while (!(IFG2&UCA0TXIFG));              // USCI_A0 TX buffer ready?
   	UCA0TXBUF = data;                  
 }
 
-unsigned char serial_recv()
+unsigned char serial_port_recv(serial_port port)
 {
+	(void)port;
+
 	return UCA0RXBUF;
 }
 
-unsigned char serial_recv_blocking()
+unsigned char serial_port_recv_blocking(serial_port port)
 {
+	(void)port;
+
     while (!(IFG2&UCA0RXIFG));         		// USCI_A0 RX buffer ready?
 	return UCA0RXBUF;
 }
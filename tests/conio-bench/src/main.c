@@ -0,0 +1,150 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef MSP430
+#include <msp430.h>
+#else
+#include <libopencm3/stm32/f1/rcc.h>
+#endif
+
+#include "serial.h"
+#include "conio.h"
+
+#ifndef MSP430
+/**
+ * Cycle counter of the DWT unit (Cortex-M3)
+ */
+#define DEMCR				(*(volatile unsigned long *)0xE000EDFC)
+#define DEMCR_TRCENA		(1 << 24)
+#define DWT_CTRL			(*(volatile unsigned long *)0xE0001000)
+#define DWT_CTRL_CYCCNTENA	(1 << 0)
+#define DWT_CYCCNT			(*(volatile unsigned long *)0xE0001004)
+#endif
+
+/**
+ * Sink discarding everything, to measure the formatting only
+ */
+static void null_write(cio_sink *sink, const char *buf, unsigned short len)
+{
+	(void)sink;
+	(void)buf;
+	(void)len;
+}
+
+cio_sink null_sink = { null_write };
+
+void clock_init(void)
+{
+#ifdef MSP430
+    WDTCTL = WDTPW + WDTHOLD;
+    BCSCTL1 = CALBC1_16MHZ;
+    DCOCTL  = CALDCO_16MHZ;
+#else
+#ifdef STM32_100
+	rcc_clock_setup_in_hse_8mhz_out_24mhz();
+#else
+	rcc_clock_setup_in_hse_8mhz_out_72mhz();
+#endif
+#endif
+}
+
+void cycles_init(void)
+{
+#ifdef MSP430
+	// Timer_A counts MCLK (SMCLK = MCLK = DCO)
+	TACTL = TASSEL_2 + MC_2 + TACLR;
+#else
+	DEMCR    |= DEMCR_TRCENA;
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+#endif
+}
+
+unsigned long cycles(void)
+{
+#ifdef MSP430
+	return TAR;
+#else
+	return DWT_CYCCNT;
+#endif
+}
+
+void report(char *name, unsigned long start, unsigned long end)
+{
+	unsigned long c;
+
+#ifdef MSP430
+	c = (unsigned int)(end - start);
+#else
+	c = end - start;
+#endif
+
+	cio_printf("%s %n cycles\n\r", name, c);
+}
+
+int main(void)
+{
+	unsigned long start;
+	char buf[32];
+
+	clock_init();
+
+#ifdef MSP430
+	serial_clk_init(16000000L, 9600);
+#else
+	serial_init(9600);
+#endif
+
+	cycles_init();
+
+	cio_printf("conio-bench\n\r");
+
+	start = cycles();
+	cio_fprintf(&null_sink, "%u", 65535);
+	report("%u 65535         ", start, cycles());
+
+	start = cycles();
+	cio_fprintf(&null_sink, "%i", -12345);
+	report("%i -12345        ", start, cycles());
+
+	start = cycles();
+	cio_fprintf(&null_sink, "%n", 4294967295UL);
+	report("%n 4294967295    ", start, cycles());
+
+	start = cycles();
+	cio_fprintf(&null_sink, "%l", -1234567890L);
+	report("%l -1234567890   ", start, cycles());
+
+	start = cycles();
+	cio_snprintf(buf, sizeof(buf), "%i %u %n", -1, 1000, 100000UL);
+	report("snprintf %i %u %n", start, cycles());
+
+	cio_set_sink(&null_sink);
+	start = cycles();
+	cio_printi(-32767);
+	cio_set_sink(&cio_sink_serial);
+	report("printi -32767    ", start, cycles());
+
+	cio_printf("DONE\n\r");
+
+	while (1) {
+		__asm__("nop");
+	}
+	return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef MSP430
+#include <msp430.h>
+#else
+#include <libopencm3/stm32/f1/rcc.h>
+#endif
+
+#include "serial.h"
+#include "serial_time.h"
+#include "conio.h"
+#include "conio_log.h"
+
+/**
+ * Ringbuffer for the log records
+ */
+SERIAL_RB_Q log_buf[64];
+
+serial_rb log_rb;
+
+void clock_init(void)
+{
+#ifdef MSP430
+    WDTCTL = WDTPW + WDTHOLD;
+    BCSCTL1 = CALBC1_16MHZ;
+    DCOCTL  = CALDCO_16MHZ;
+#else
+#ifdef STM32_100
+	rcc_clock_setup_in_hse_8mhz_out_24mhz();
+#else
+	rcc_clock_setup_in_hse_8mhz_out_72mhz();
+#endif
+#endif
+}
+
+int main(void)
+{
+	unsigned long last = 0;
+	int i = 0;
+
+	clock_init();
+
+#ifdef MSP430
+	serial_clk_init(16000000L, 9600);
+	serial_time_init(16000000L);
+#else
+	serial_init(9600);
+#ifdef STM32_100
+	serial_time_init(24000000L);
+#else
+	serial_time_init(72000000L);
+#endif
+#endif
+
+	serial_rb_init(&log_rb, log_buf, sizeof(log_buf));
+	cio_log_init(&log_rb, serial_time_ms);
+
+	CIO_LOG("conio-log\n\r");
+
+	while (1) {
+		if(serial_time_ms() - last >= 500) {
+			last = serial_time_ms();
+
+			// only the ID, the timestamp and the raw arguments are queued
+			CIO_LOG("count %i, neg %i, hex %x, long %l\n\r", i, -i, i, (long)i * -100000L);
+			i++;
+		}
+
+		// send the queued records (e.g. logged from an ISR) when idle
+		cio_log_flush(&cio_sink_serial);
+	}
+	return 0;
+}
@@ -134,6 +134,32 @@ int main(void)
 
     cio_printf("all %s %c %i %u %l %n %x\n\r", s, c, i, u, l, n, x);
 
+	// Test printing into memory
+	char buf[16];
+	int len;
+
+	len = cio_snprintf(buf, sizeof(buf), "%s %i %x", s, i, x);
+	cio_printf("snprintf '%s' %i (test -12345 ABC 16)\n\r", buf, len);
+
+	// Test field width, padding and fixed-point
+	cio_printf("width [%6i] (     -1)\n\r", -1);
+	cio_printf("left  [%-6u] (42    )\n\r", 42);
+	cio_printf("zero  [%06i] (-00042)\n\r", -42);
+	cio_printf("hex   [%02x] (0F)\n\r", 15);
+	cio_printf("lhex  [%lx] (DEADBEEF)\n\r", 0xDEADBEEFUL);
+	cio_printf("fixed [%7.2l] (-123.45)\n\r", -12345L);
+	cio_printf("fixed [%.3u] (0.007)\n\r", 7);
+
+	// Test dumps
+	cio_print("hexdump (conio dump test.)\n\r");
+	cio_snprintf(buf, sizeof(buf), "conio dump test");
+	cio_hexdump(buf, sizeof(buf));
+
+	cio_print("bindump (00101010 11111111)\n\r");
+	buf[0] = 42;
+	buf[1] = 255;
+	cio_bindump(buf, 2);
+
 	cio_printf("DONE\n\r");
 
 
@@ -0,0 +1,175 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef MSP430
+#include <msp430.h>
+#else
+#include <libopencm3/stm32/f1/rcc.h>
+#endif
+
+#include "serial.h"
+#include "conio.h"
+#include "crc.h"
+
+#ifndef MSP430
+/**
+ * Cycle counter of the DWT unit (Cortex-M3)
+ */
+#define DEMCR				(*(volatile unsigned long *)0xE000EDFC)
+#define DEMCR_TRCENA		(1 << 24)
+#define DWT_CTRL			(*(volatile unsigned long *)0xE0001000)
+#define DWT_CTRL_CYCCNTENA	(1 << 0)
+#define DWT_CYCCNT			(*(volatile unsigned long *)0xE0001004)
+#endif
+
+/**
+ * Number of bytes to calculate the CRCs over (small enough for the 16 bit
+ * timer of the MSP430 not to overflow with the bitwise variants)
+ */
+#define DATA_LEN	64
+
+unsigned char data[DATA_LEN];
+
+void clock_init(void)
+{
+#ifdef MSP430
+    WDTCTL = WDTPW + WDTHOLD;
+    BCSCTL1 = CALBC1_16MHZ;
+    DCOCTL  = CALDCO_16MHZ;
+#else
+#ifdef STM32_100
+	rcc_clock_setup_in_hse_8mhz_out_24mhz();
+#else
+	rcc_clock_setup_in_hse_8mhz_out_72mhz();
+#endif
+#endif
+}
+
+void cycles_init(void)
+{
+#ifdef MSP430
+	// Timer_A counts MCLK (SMCLK = MCLK = DCO)
+	TACTL = TASSEL_2 + MC_2 + TACLR;
+#else
+	DEMCR    |= DEMCR_TRCENA;
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+#endif
+}
+
+unsigned long cycles(void)
+{
+#ifdef MSP430
+	return TAR;
+#else
+	return DWT_CYCCNT;
+#endif
+}
+
+void report(char *name, unsigned long crc, unsigned long check, unsigned long start, unsigned long end)
+{
+	unsigned long c;
+
+#ifdef MSP430
+	c = (unsigned int)(end - start);
+#else
+	c = end - start;
+#endif
+
+	cio_printf("%s %s %n cycles, %n bytes/kcycle\n\r", name, (crc == check ? "OK  " : "FAIL"),
+			   c, (DATA_LEN * 1000UL) / c);
+}
+
+int main(void)
+{
+	unsigned long start;
+	unsigned long crc;
+	unsigned char i;
+
+	clock_init();
+
+#ifdef MSP430
+	serial_clk_init(16000000L, 9600);
+#else
+	serial_init(9600);
+	crc32_hw_init();
+#endif
+
+	cycles_init();
+
+	for(i = 0; i < DATA_LEN; i++) {
+		data[i] = i;
+	}
+
+	// reference CRCs of the test data
+	unsigned char  c8  = crc8_bit(CRC8_INIT, data, DATA_LEN);
+	unsigned short c16 = crc16_bit(CRC16_INIT, data, DATA_LEN);
+	unsigned long  c32 = crc32_bit(CRC32_INIT, data, DATA_LEN);
+
+	cio_printf("crc-bench (%i bytes)\n\r", DATA_LEN);
+
+	start = cycles();
+	crc = crc8_bit(CRC8_INIT, data, DATA_LEN);
+	report("crc8_bit    ", crc, c8, start, cycles());
+
+	start = cycles();
+	crc = crc8_nibble(CRC8_INIT, data, DATA_LEN);
+	report("crc8_nibble ", crc, c8, start, cycles());
+
+	start = cycles();
+	crc = crc8_byte(CRC8_INIT, data, DATA_LEN);
+	report("crc8_byte   ", crc, c8, start, cycles());
+
+	start = cycles();
+	crc = crc16_bit(CRC16_INIT, data, DATA_LEN);
+	report("crc16_bit   ", crc, c16, start, cycles());
+
+	start = cycles();
+	crc = crc16_nibble(CRC16_INIT, data, DATA_LEN);
+	report("crc16_nibble", crc, c16, start, cycles());
+
+	start = cycles();
+	crc = crc16_byte(CRC16_INIT, data, DATA_LEN);
+	report("crc16_byte  ", crc, c16, start, cycles());
+
+	start = cycles();
+	crc = crc32_bit(CRC32_INIT, data, DATA_LEN);
+	report("crc32_bit   ", crc, c32, start, cycles());
+
+	start = cycles();
+	crc = crc32_nibble(CRC32_INIT, data, DATA_LEN);
+	report("crc32_nibble", crc, c32, start, cycles());
+
+	start = cycles();
+	crc = crc32_byte(CRC32_INIT, data, DATA_LEN);
+	report("crc32_byte  ", crc, c32, start, cycles());
+
+#ifndef MSP430
+	start = cycles();
+	crc = crc32_hw(data, DATA_LEN);
+	report("crc32_hw    ", crc, c32, start, cycles());
+#endif
+
+	cio_printf("DONE\n\r");
+
+	while (1) {
+		__asm__("nop");
+	}
+	return 0;
+}
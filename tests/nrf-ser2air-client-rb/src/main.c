@@ -23,12 +23,11 @@
 #else
 #include <libopencm3/stm32/f1/rcc.h>
 #include <libopencm3/stm32/f1/gpio.h>
-#include <libopencm3/stm32/usart.h>
-#include <libopencm3/stm32/f1/nvic.h>
 #endif
 
 #include "serial.h"
 #include "serial_rb.h"
+#include "serial_irq.h"
 #include "conio.h"
 #include "nrf24l01.h"
 
@@ -105,17 +104,7 @@ void serirq_init(void)
     serial_rb_init(&srx, &(srx_buf[0]), RB_SIZE);
     serial_rb_init(&stx, &(stx_buf[0]), RB_SIZE);
 
-#ifdef MSP430
-    IE2 |= UCA0RXIE; 
-	__bis_SR_register(GIE);
-#else
-
-	/* Enable the USART1 interrupt. */
-	nvic_enable_irq(NVIC_USART1_IRQ);
-
-	/* Enable USART1 Receive interrupt. */
-	USART_CR1(USART1) |= USART_CR1_RXNEIE;
-#endif
+    serial_irq_init(&srx, &stx);
 }
 
 void nrf_configure_esbpl_rx(void)
@@ -136,61 +125,11 @@ void nrf_configure_esbpl_rx(void)
 	delay(10000 * DF);
 }
 
-#ifdef MSP430
-interrupt(USCIAB0RX_VECTOR) USCI0RX_ISR(void)
-{
-	if (!serial_rb_full(&srx)) {
-        serial_rb_write(&srx, UCA0RXBUF);
-	}
-}
-
-interrupt(USCIAB0TX_VECTOR) USCI0TX_ISR(void)
-{
-	if(!serial_rb_empty(&stx)) {
-    	serial_send(serial_rb_read(&stx));
-    }
-    else {
-    	/* Disable the TX interrupt, it's no longer needed. */
-		IE2 &= ~UCA0TXIE; 
-    }
-}
-#else
-void usart1_isr(void)
-{
-    unsigned char c;
-
-	/* Check if we were called because of RXNE. */
-	if (((USART_CR1(USART1) & USART_CR1_RXNEIE) != 0) &&
-        ((USART_SR(USART1) & USART_SR_RXNE) != 0) &&
-        (!serial_rb_full(&srx))) {
-        c = serial_recv();
-        serial_rb_write(&srx, c);
-	}
-	/* Check if we were called because of TXE. */
-	else if (((USART_CR1(USART1) & USART_CR1_TXEIE) != 0) &&
-             ((USART_SR(USART1) & USART_SR_TXE) != 0)) {
-
-        if(!serial_rb_empty(&stx)) {
-            // serial_send_blocking(serial_rb_read(&stx));
-            serial_send(serial_rb_read(&stx));
-        }
-        else {
-            /* Disable the TXE interrupt, it's no longer needed. */
-            USART_CR1(USART1) &= ~USART_CR1_TXEIE;
-        }
-	}
-	else {
-        c = serial_recv();
-	}
-}
-#endif
-
 int main(void)
 {
     unsigned char cnt = 0;
 
     int s;
-    int i;
 
 	clock_init();
 	gpio_init();
@@ -216,12 +155,7 @@ int main(void)
 #endif
         }
 
-        ptx.data[0] = PL_NOP;
-
-        while(!serial_rb_empty(&srx) && ptx.data[0] < PL_SIZE) {
-			ptx.data[ptx.data[0] + 1] = serial_rb_read(&srx);
-			ptx.data[0]++;
-        }
+        ptx.data[0] = serial_read(&(ptx.data[1]), PL_SIZE);
 
         if(ptx.data[0] > 0) {
 #ifdef MSP430
@@ -236,14 +170,11 @@ int main(void)
 		s = nrf_receive_blocking(&prx);
 
 		if(s != 0 && prx.data[0] != PL_NOP) {
-            if(!serial_rb_full(&stx)) {
-                for(i = 0; i < prx.data[0]; i++) serial_rb_write(&stx, prx.data[i + 1]);
+            if(serial_write(&(prx.data[1]), prx.data[0]) > 0) {
 #ifdef MSP430
 				P1OUT |= RXTX_LED;
-				IE2 |= UCA0TXIE;
 #else
              	gpio_set(GPIOC, RX_LED);
-               	USART_CR1(USART1) |= USART_CR1_TXEIE;
 #endif
             }
 		}
@@ -0,0 +1,72 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "serial.h"
+#include "serial_rb.h"
+#include "serial_irq.h"
+
+#define RB_SIZE 4096
+
+static SERIAL_RB_Q srx_buf[RB_SIZE];
+static serial_rb srx;
+
+static SERIAL_RB_Q stx_buf[RB_SIZE];
+static serial_rb stx;
+
+int main(void)
+{
+	unsigned char buf[256];
+	unsigned short n;
+	unsigned short w;
+	unsigned long total = 0;
+	time_t last = time(0);
+
+	serial_init(115200);
+
+	serial_rb_init(&srx, &(srx_buf[0]), RB_SIZE);
+	serial_rb_init(&stx, &(stx_buf[0]), RB_SIZE);
+
+	serial_irq_init(&srx, &stx);
+
+	while (1) {
+		n = serial_read(buf, sizeof(buf));
+
+		for(w = 0; w < n; ) {
+			w += serial_write(&(buf[w]), n - w);
+		}
+
+		total += n;
+
+		if(n == 0) {
+			usleep(100);
+		}
+
+		if(time(0) != last) {
+			last = time(0);
+			fprintf(stderr, "echoed %lu, rx hwm %u, rx dropped %lu\n",
+					total, srx.stats.hwm, srx.stats.dropped);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * This file is part of the libemb project.
+ *
+ * Copyright (C) 2011 Stefan Wendler <sw@kaltpost.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "serial.h"
+#include "serial_rb.h"
+#include "serial_irq.h"
+#include "serial_pty_host.h"
+
+/*
+ * A small RX ringbuffer and reads not matching its size make the RX thread
+ * find the ringbuffer full often, and the reader free it again right after.
+ */
+#define RB_SIZE		64
+
+#define READ_LEN	7
+
+#define TOTAL		(4UL * 1024 * 1024)
+
+/**
+ * Seconds without progress after which RX is considered stalled
+ */
+#define STALL_SECS	3
+
+static SERIAL_RB_Q srx_buf[RB_SIZE];
+static serial_rb srx;
+
+static unsigned char pattern(unsigned long i)
+{
+	return (unsigned char)(i ^ (i >> 8) ^ (i >> 16));
+}
+
+/**
+ * Peer: write a known stream into the slave side of the pty.
+ */
+static void *writer(void *arg)
+{
+	unsigned char buf[1024];
+	unsigned long sent = 0;
+	unsigned short i;
+	ssize_t n;
+	int fd;
+
+	(void)arg;
+
+	fd = open(ptsname(serial_pty_fds[SERIAL_PORT1]), O_WRONLY | O_NOCTTY);
+
+	if(fd < 0) {
+		perror("open pty slave");
+		exit(1);
+	}
+
+	while(sent < TOTAL) {
+		for(i = 0; i < sizeof(buf); i++) {
+			buf[i] = pattern(sent + i);
+		}
+
+		n = write(fd, buf, sizeof(buf));
+
+		if(n > 0) {
+			sent += n;
+		}
+	}
+
+	return 0;
+}
+
+int main(void)
+{
+	unsigned char buf[READ_LEN];
+	unsigned long total = 0;
+	unsigned short n;
+	unsigned short i;
+	time_t last = time(0);
+	pthread_t thread;
+
+	serial_init(115200);
+
+	serial_rb_init(&srx, &(srx_buf[0]), RB_SIZE);
+
+	/* RX only, the thread must still be woken when room is made. */
+	serial_irq_init(&srx, 0);
+
+	pthread_create(&thread, 0, writer, 0);
+
+	while(total < TOTAL) {
+		n = serial_read(buf, sizeof(buf));
+
+		for(i = 0; i < n; i++, total++) {
+			if(buf[i] != pattern(total)) {
+				fprintf(stderr, "FAIL: wrong byte at %lu\n", total);
+				return 1;
+			}
+		}
+
+		if(n > 0) {
+			last = time(0);
+		}
+		else if(time(0) - last > STALL_SECS) {
+			fprintf(stderr, "FAIL: RX stalled after %lu bytes (rx used %u)\n",
+					total, serial_rb_used(&srx));
+			return 1;
+		}
+	}
+
+	fprintf(stderr, "PASS: received %lu bytes, rx hwm %u, rx dropped %lu\n",
+			total, srx.stats.hwm, srx.stats.dropped);
+
+	return 0;
+}